@@ -0,0 +1,82 @@
+#include "algorithms/dijkstra.hpp"
+#include "builder.hpp"
+#include "memory/arena.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Edges of one short-lived per-request subgraph: a road-like grid of
+/// `side` x `side` nodes.
+std::vector<std::tuple<DefaultIx, DefaultIx, float>> const& request_edges(std::size_t side)
+{
+    static std::vector<std::tuple<DefaultIx, DefaultIx, float>> edges;
+    static std::size_t cached = 0;
+    if (cached != side) {
+        edges = generators::road_like_edges<DefaultIx, float>(side);
+        cached = side;
+    }
+    return edges;
+}
+
+template <typename G>
+float edge_weight(typename G::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// One request: build the subgraph edge by edge, run a full Dijkstra into a
+/// fresh workspace, drop both.
+template <typename G, typename Alloc>
+void run_request(std::vector<std::tuple<DefaultIx, DefaultIx, float>> const& edges, std::size_t n, Alloc const& alloc)
+{
+    G graph(alloc);
+    for (std::size_t i = 0; i < n; ++i) {
+        graph.add_node(0);
+    }
+    for (auto const& e : edges) {
+        graph.add_edge(NodeIndex<DefaultIx>(std::get<0>(e)), NodeIndex<DefaultIx>(std::get<1>(e)), std::get<2>(e));
+    }
+    SearchWorkspace<DefaultIx, float, Alloc> ws(alloc);
+    dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight<G>, ws);
+    benchmark::DoNotOptimize(ws.distance.data());
+}
+
+/// Build-query-drop cycle with every vector on the default heap.
+void BM_RequestHeap(benchmark::State& state)
+{
+    using Alloc = std::allocator<char>;
+    auto const side = static_cast<std::size_t>(state.range(0));
+    auto const& edges = request_edges(side);
+    for (auto _ : state) {
+        run_request<DiGraph<int, float, DefaultIx, AosStorage, Alloc>>(edges, side * side, Alloc());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/// The same cycle drawing from one arena that is reset after each request,
+/// so after the first request nothing reaches malloc.
+void BM_RequestArena(benchmark::State& state)
+{
+    using Alloc = ArenaAllocator<char>;
+    auto const side = static_cast<std::size_t>(state.range(0));
+    auto const& edges = request_edges(side);
+    MonotonicArena arena;
+    for (auto _ : state) {
+        run_request<DiGraph<int, float, DefaultIx, AosStorage, Alloc>>(edges, side * side, Alloc(arena));
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+    state.counters["arena_kib"] = static_cast<double>(arena.capacity()) / 1024;
+}
+
+}
+
+BENCHMARK(BM_RequestHeap)->ArgName("side")->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RequestArena)->ArgName("side")->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,74 @@
+#include "csr.hpp"
+#include "visit/bfsvisit.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+CsrGraph<int, float> const& power_law_graph()
+{
+    static auto const csr = freeze(generators::rmat<BenchGraph>(18, 16));
+    return csr;
+}
+
+/// Edges scanned by a full traversal of the reached component.
+std::size_t component_edges(CsrGraph<int, float> const& graph, BfsResult<DefaultIx> const& result)
+{
+    std::size_t edges = 0;
+    for (std::size_t v = 0; v < graph.node_count(); ++v) {
+        if (result.reachable(NodeIndex<DefaultIx>(static_cast<DefaultIx>(v)))) {
+            edges += graph.degree(NodeIndex<DefaultIx>(static_cast<DefaultIx>(v)));
+        }
+    }
+    return edges;
+}
+
+void BM_DirectionOptimizingBfs(benchmark::State& state)
+{
+    auto const& graph = power_law_graph();
+    ThreadPool pool(state.range(0));
+    std::size_t edges = 0;
+    for (auto _ : state) {
+        auto const result = breadth_first_search(graph, NodeIndex<DefaultIx>(0), pool);
+        state.PauseTiming();
+        edges += component_edges(graph, result);
+        state.ResumeTiming();
+    }
+    state.counters["TEPS"] = benchmark::Counter(static_cast<double>(edges), benchmark::Counter::kIsRate);
+}
+
+void BM_TopDownOnlyBfs(benchmark::State& state)
+{
+    auto const& graph = power_law_graph();
+    ThreadPool pool(state.range(0));
+    BfsOptions options;
+    options.alpha = 1;
+    std::size_t edges = 0;
+    for (auto _ : state) {
+        auto const result = breadth_first_search(graph, NodeIndex<DefaultIx>(0), pool, options);
+        state.PauseTiming();
+        edges += component_edges(graph, result);
+        state.ResumeTiming();
+    }
+    state.counters["TEPS"] = benchmark::Counter(static_cast<double>(edges), benchmark::Counter::kIsRate);
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench)
+{
+    for (long threads : {1L, 2L, 4L}) {
+        bench->Arg(threads);
+    }
+    auto const all = static_cast<long>(ThreadPool::default_size());
+    if (all > 4) {
+        bench->Arg(all);
+    }
+}
+
+}
+
+BENCHMARK(BM_DirectionOptimizingBfs)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TopDownOnlyBfs)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#include "builder.hpp"
+#include "io/binary.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+std::string const& graph_file()
+{
+    static std::string const path = [] {
+        std::string p = "graph_bench_load.bin";
+        save_binary(from_edges<BenchGraph>(generators::rmat_edges<DefaultIx, float>(20, 16), std::size_t(1) << 20), p);
+        std::atexit([] { std::remove("graph_bench_load.bin"); });
+        return p;
+    }();
+    return path;
+}
+
+void BM_OpenMapped(benchmark::State& state)
+{
+    auto const& path = graph_file();
+    for (auto _ : state) {
+        MappedGraph<int, float, true, DefaultIx> graph(path);
+        benchmark::DoNotOptimize(graph.edge_count());
+    }
+}
+
+void BM_OpenMappedVerified(benchmark::State& state)
+{
+    auto const& path = graph_file();
+    for (auto _ : state) {
+        MappedGraph<int, float, true, DefaultIx> graph(path, true);
+        benchmark::DoNotOptimize(graph.edge_count());
+    }
+}
+
+void BM_RebuildFromEdgeList(benchmark::State& state)
+{
+    auto const edges = generators::rmat_edges<DefaultIx, float>(20, 16);
+    for (auto _ : state) {
+        auto const graph = from_edges<BenchGraph>(edges, std::size_t(1) << 20);
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+}
+
+void BM_SaveBinary(benchmark::State& state)
+{
+    auto const graph = from_edges<BenchGraph>(generators::rmat_edges<DefaultIx, float>(20, 16), std::size_t(1) << 20);
+    for (auto _ : state) {
+        save_binary(graph, "graph_bench_save.bin");
+    }
+    std::remove("graph_bench_save.bin");
+    state.SetBytesProcessed(state.iterations() * (graph.nodes.size() * sizeof(graph.nodes[0]) + graph.edges.size() * sizeof(graph.edges[0])));
+}
+
+}
+
+BENCHMARK(BM_OpenMapped)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OpenMappedVerified)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RebuildFromEdgeList)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SaveBinary)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON reports.
+
+    ./graph_bench --benchmark_filter='BM_(AddNode|AddEdge|NeighborIteration|Dfs|Dijkstra)/' \\
+        --benchmark_out=current.json --benchmark_out_format=json
+    bench/compare.py bench/baseline.json current.json
+
+Benchmarks are matched by name. For each one the script prints both times,
+the relative change, and the change in every shared counter. It exits with
+status 1 if any benchmark got slower than --threshold (default 10%), so it
+can gate a CI job. Benchmarks present in only one report are listed but never
+fail the comparison.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        report = json.load(f)
+    runs = {}
+    for run in report.get("benchmarks", []):
+        if run.get("run_type", "iteration") != "iteration":
+            continue
+        runs[run["name"]] = run
+    return runs
+
+
+def change(old, new):
+    if old == 0:
+        return 0.0
+    return (new - old) / old
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10, help="relative slowdown that counts as a regression")
+    parser.add_argument("--metric", default="cpu_time", choices=["cpu_time", "real_time"])
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = []
+
+    width = max([len(name) for name in baseline.keys() & current.keys()] + [9])
+    print("%-*s %14s %14s %9s" % (width, "benchmark", "baseline", "current", "change"))
+    for name in sorted(baseline.keys() & current.keys(), key=list(current).index):
+        old, new = baseline[name], current[name]
+        delta = change(old[args.metric], new[args.metric])
+        unit = new.get("time_unit", "ns")
+        flag = ""
+        if delta > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print("%-*s %11.4g %-2s %11.4g %-2s %+8.1f%%%s"
+              % (width, name, old[args.metric], unit, new[args.metric], unit, 100 * delta, flag))
+        for counter in sorted(set(old) & set(new)):
+            if counter in ("items_per_second", "bytes_per_second", "graph_bytes", "bytes_per_edge"):
+                print("%-*s   %-18s %+8.1f%%" % (width, "", counter, 100 * change(old[counter], new[counter])))
+
+    for name in sorted(baseline.keys() - current.keys()):
+        print("only in baseline: %s" % name)
+    for name in sorted(current.keys() - baseline.keys()):
+        print("only in current:  %s" % name)
+
+    if regressions:
+        print("\n%d benchmark(s) slower than %.0f%%:" % (len(regressions), 100 * args.threshold))
+        for name in regressions:
+            print("  " + name)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,75 @@
+#include "algorithms/components.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+
+/// R-MAT graphs with 2^18 nodes; the directed one has a giant strongly
+/// connected core and a long fringe of small components.
+UnGraph<int, float> const& undirected()
+{
+    static UnGraph<int, float> const graph = generators::rmat<UnGraph<int, float>>(18, 4);
+    return graph;
+}
+
+DiGraph<int, float> const& directed()
+{
+    static DiGraph<int, float> const graph = generators::rmat<DiGraph<int, float>>(18, 4);
+    return graph;
+}
+
+void BM_ConnectedComponents(benchmark::State& state)
+{
+    auto const& graph = undirected();
+    ThreadPool pool(state.range(0));
+    for (auto _ : state) {
+        auto const components = connected_components(graph, pool);
+        benchmark::DoNotOptimize(components.component_id.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void BM_TarjanScc(benchmark::State& state)
+{
+    auto const& graph = directed();
+    std::size_t count = 0;
+    for (auto _ : state) {
+        count = strongly_connected_components(graph).count;
+    }
+    state.counters["components"] = static_cast<double>(count);
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void BM_ParallelScc(benchmark::State& state)
+{
+    auto const& graph = directed();
+    ThreadPool pool(state.range(0));
+    std::size_t count = 0;
+    for (auto _ : state) {
+        count = strongly_connected_components(graph, pool).count;
+    }
+    state.counters["components"] = static_cast<double>(count);
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgName("threads");
+    for (long threads : {1L, 2L, 4L}) {
+        bench->Arg(threads);
+    }
+    auto const all = static_cast<long>(ThreadPool::default_size());
+    if (all > 4) {
+        bench->Arg(all);
+    }
+}
+
+}
+
+BENCHMARK(BM_ConnectedComponents)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TarjanScc)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelScc)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/point_to_point.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+std::size_t const side = 256;
+
+BenchGraph const& road_network()
+{
+    static auto const graph = generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side);
+    return graph;
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+ContractionHierarchy<DefaultIx, float> const& road_hierarchy()
+{
+    static auto const ch = contract(road_network(), edge_weight);
+    return ch;
+}
+
+void BM_ContractRoadNetwork(benchmark::State& state)
+{
+    auto const& graph = road_network();
+    ThreadPool pool(state.range(0));
+    ContractionOptions options;
+    options.pool = &pool;
+    std::size_t shortcuts = 0;
+    for (auto _ : state) {
+        auto const ch = contract(graph, edge_weight, options);
+        shortcuts = ch.shortcut_count();
+    }
+    state.counters["shortcuts"] = static_cast<double>(shortcuts);
+}
+
+void BM_ChQuery(benchmark::State& state)
+{
+    auto const& ch = road_hierarchy();
+    ChQueryWorkspace<DefaultIx, float> ws;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(ch.node_count() - 1));
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        auto const s = pick(rng);
+        auto const path = ch.query(NodeIndex<DefaultIx>(s), NodeIndex<DefaultIx>(pick(rng)), ws);
+        benchmark::DoNotOptimize(path.distance);
+        settled += path.settled;
+    }
+    state.counters["settled_per_query"] = static_cast<double>(settled) / state.iterations();
+}
+
+void BM_ChBaselineBidirectional(benchmark::State& state)
+{
+    auto const& graph = road_network();
+    BidirectionalWorkspace<DefaultIx, float> ws;
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(graph.node_count() - 1));
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        auto const s = pick(rng);
+        auto const path = bidirectional_dijkstra(graph, NodeIndex<DefaultIx>(s), NodeIndex<DefaultIx>(pick(rng)), edge_weight, ws);
+        benchmark::DoNotOptimize(path.distance);
+        settled += path.settled;
+    }
+    state.counters["settled_per_query"] = static_cast<double>(settled) / state.iterations();
+}
+
+}
+
+BENCHMARK(BM_ContractRoadNetwork)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ChQuery)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ChBaselineBidirectional)->Unit(benchmark::kMicrosecond);
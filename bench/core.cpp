@@ -0,0 +1,192 @@
+#include "algorithms/dijkstra.hpp"
+#include "visit/dfsvisit.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using EdgeList = std::vector<std::tuple<DefaultIx, DefaultIx, float>>;
+
+/// Graph families of the core suite, selected by the first benchmark
+/// argument. The second argument is log2 of the node count.
+enum Family {
+    Grid,
+    ErdosRenyi,
+    Rmat,
+    RoadLike
+};
+
+char const* family_name(long family)
+{
+    switch (family) {
+    case Grid:
+        return "grid";
+    case ErdosRenyi:
+        return "erdos_renyi";
+    case Rmat:
+        return "rmat";
+    case RoadLike:
+        return "road_like";
+    }
+    return "";
+}
+
+EdgeList const& edge_list(long family, long scale)
+{
+    static std::map<std::pair<long, long>, EdgeList> cache;
+    auto& edges = cache[std::make_pair(family, scale)];
+    if (edges.empty()) {
+        auto const n = std::size_t(1) << scale;
+        auto const side = std::size_t(1) << (scale / 2);
+        switch (family) {
+        case Grid:
+            edges = generators::grid_edges<DefaultIx, float>(side);
+            break;
+        case ErdosRenyi:
+            edges = generators::erdos_renyi_edges<DefaultIx, float>(n, 8);
+            break;
+        case Rmat:
+            edges = generators::rmat_edges<DefaultIx, float>(static_cast<unsigned>(scale), 8);
+            break;
+        case RoadLike:
+            edges = generators::road_like_edges<DefaultIx, float>(side);
+            break;
+        }
+    }
+    return edges;
+}
+
+BenchGraph const& graph_for(long family, long scale)
+{
+    static std::map<std::pair<long, long>, BenchGraph> cache;
+    auto const key = std::make_pair(family, scale);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, generators::build<BenchGraph>(edge_list(family, scale), std::size_t(1) << scale)).first;
+    }
+    return it->second;
+}
+
+/// Reports the node and edge storage of `graph`, and labels the run with its
+/// family.
+void report_memory(benchmark::State& state, BenchGraph const& graph)
+{
+    auto const bytes = graph.nodes.size() * sizeof(graph.nodes[0]) + graph.edges.size() * sizeof(graph.edges[0]);
+    state.counters["graph_bytes"] = static_cast<double>(bytes);
+    state.counters["bytes_per_edge"] = graph.edge_count() ? static_cast<double>(bytes) / graph.edge_count() : 0.0;
+    state.SetLabel(family_name(state.range(0)));
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+void BM_AddNode(benchmark::State& state)
+{
+    auto const n = std::size_t(1) << state.range(0);
+    for (auto _ : state) {
+        BenchGraph graph;
+        for (std::size_t i = 0; i < n; ++i) {
+            graph.add_node(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(graph.nodes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+void BM_AddEdge(benchmark::State& state)
+{
+    auto const& edges = edge_list(state.range(0), state.range(1));
+    auto const n = std::size_t(1) << state.range(1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        BenchGraph graph;
+        for (std::size_t i = 0; i < n; ++i) {
+            graph.add_node(0);
+        }
+        state.ResumeTiming();
+        for (auto const& e : edges) {
+            graph.add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        }
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+    report_memory(state, graph_for(state.range(0), state.range(1)));
+}
+
+void BM_NeighborIteration(benchmark::State& state)
+{
+    auto const& graph = graph_for(state.range(0), state.range(1));
+    for (auto _ : state) {
+        std::size_t sum = 0;
+        for (std::size_t u = 0; u < graph.node_count(); ++u) {
+            for (auto const& edge : graph.edges_of(NodeIndex<DefaultIx>(static_cast<DefaultIx>(u)))) {
+                sum += edge.target().index();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+    report_memory(state, graph);
+}
+
+void BM_Dfs(benchmark::State& state)
+{
+    auto const& graph = graph_for(state.range(0), state.range(1));
+    DfsWorkspace<BenchGraph> ws;
+    std::size_t edges = 0;
+    for (auto _ : state) {
+        depth_first_search(graph, NodeIndex<DefaultIx>(0), [&](DfsEvent<NodeIndex<DefaultIx>> const& event) {
+            edges += event.kind != DfsEvent<NodeIndex<DefaultIx>>::Kind::Discover && event.kind != DfsEvent<NodeIndex<DefaultIx>>::Kind::Finish;
+        }, ws);
+    }
+    state.SetItemsProcessed(edges);
+    report_memory(state, graph);
+}
+
+void BM_Dijkstra(benchmark::State& state)
+{
+    auto const& graph = graph_for(state.range(0), state.range(1));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(graph.node_count() - 1));
+    SearchWorkspace<DefaultIx, float> ws;
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        dijkstra(graph, NodeIndex<DefaultIx>(pick(rng)), edge_weight, ws);
+        state.PauseTiming();
+        for (std::size_t v = 0; v < graph.node_count(); ++v) {
+            settled += ws.reachable(NodeIndex<DefaultIx>(static_cast<DefaultIx>(v)));
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(settled);
+    report_memory(state, graph);
+}
+
+void families_and_sizes(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"family", "scale"});
+    for (long family : {Grid, ErdosRenyi, Rmat, RoadLike}) {
+        for (long scale : {12L, 16L, 20L}) {
+            bench->Args({family, scale});
+        }
+    }
+}
+
+}
+
+BENCHMARK(BM_AddNode)->ArgName("scale")->Arg(12)->Arg(16)->Arg(20);
+BENCHMARK(BM_AddEdge)->Apply(families_and_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NeighborIteration)->Apply(families_and_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Dfs)->Apply(families_and_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Dijkstra)->Apply(families_and_sizes)->Unit(benchmark::kMillisecond);
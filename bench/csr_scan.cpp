@@ -0,0 +1,58 @@
+#include "csr.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+DiGraph<int, float> random_graph(std::size_t nodes, std::size_t degree)
+{
+    DiGraph<int, float> graph;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(nodes - 1));
+    std::uniform_real_distribution<float> weight(1.0f, 10.0f);
+
+    for (std::size_t i = 0; i < nodes; ++i) {
+        graph.add_node(static_cast<int>(i));
+    }
+    for (std::size_t i = 0; i < nodes * degree; ++i) {
+        graph.add_edge(pick(rng), pick(rng), weight(rng));
+    }
+    return graph;
+}
+
+template <typename G>
+float scan_all(G const& graph)
+{
+    float sum = 0;
+    for (std::size_t u = 0; u < graph.node_count(); ++u) {
+        for (auto const& edge : graph.edges_of(NodeIndex<DefaultIx>(static_cast<DefaultIx>(u)))) {
+            sum += edge.weight();
+        }
+    }
+    return sum;
+}
+
+void BM_NeighborScanLinkedList(benchmark::State& state)
+{
+    auto const graph = random_graph(state.range(0), 8);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scan_all(graph));
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void BM_NeighborScanCsr(benchmark::State& state)
+{
+    auto const csr = freeze(random_graph(state.range(0), 8));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scan_all(csr));
+    }
+    state.SetItemsProcessed(state.iterations() * csr.edge_count());
+}
+
+}
+
+BENCHMARK(BM_NeighborScanLinkedList)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BM_NeighborScanCsr)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
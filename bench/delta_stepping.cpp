@@ -0,0 +1,70 @@
+#include "algorithms/delta_stepping.hpp"
+#include "algorithms/dijkstra.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+/// R-MAT graph with 2^16 nodes and costs in [1, 100]: low diameter, which
+/// suits delta-stepping, unlike the road-like family.
+BenchGraph const& network()
+{
+    static BenchGraph const graph = generators::rmat<BenchGraph>(16, 16);
+    return graph;
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Sequential baseline for the same full distance map.
+void BM_DeltaSteppingDijkstra(benchmark::State& state)
+{
+    auto const& graph = network();
+    DijkstraResult<DefaultIx, float> result;
+    for (auto _ : state) {
+        dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight, result);
+        benchmark::DoNotOptimize(result.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+/// First argument is the thread count, second the bucket width.
+void BM_DeltaStepping(benchmark::State& state)
+{
+    auto const& graph = network();
+    ThreadPool pool(state.range(0));
+    auto const delta = static_cast<float>(state.range(1));
+    for (auto _ : state) {
+        auto const result = delta_stepping(graph, NodeIndex<DefaultIx>(0), edge_weight, delta, pool);
+        benchmark::DoNotOptimize(result.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void threads_and_deltas(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"threads", "delta"});
+    std::vector<long> threads{1, 2, 4};
+    auto const all = static_cast<long>(ThreadPool::default_size());
+    if (all > 4) {
+        threads.push_back(all);
+    }
+    for (auto t : threads) {
+        for (long delta : {10L, 50L, 200L}) {
+            bench->Args({t, delta});
+        }
+    }
+}
+
+}
+
+BENCHMARK(BM_DeltaSteppingDijkstra)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaStepping)->Apply(threads_and_deltas)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,88 @@
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/dynamic_sssp.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+std::size_t const side = 256;
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Road-like network whose edge weights are jittered around their original
+/// value, the way live traffic costs drift.
+struct Traffic
+{
+    Traffic()
+    : graph(generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side))
+    , rng(11)
+    , pick(0, static_cast<DefaultIx>(graph.edge_count() - 1))
+    , factor(0.8f, 1.25f)
+    {
+        for (std::size_t e = 0; e < graph.edge_count(); ++e) {
+            original.push_back(graph.edge_weight(EdgeIndex<DefaultIx>(e)));
+        }
+    }
+
+    /// Re-weights `count` random edges and records them in `changed`.
+    void jitter(std::size_t count)
+    {
+        changed.clear();
+        for (std::size_t k = 0; k < count; ++k) {
+            auto const e = EdgeIndex<DefaultIx>(pick(rng));
+            graph.edge_weight(e) = original[e.index()] * factor(rng);
+            changed.push_back(e);
+        }
+    }
+
+    BenchGraph graph;
+    std::vector<float> original;
+    std::vector<EdgeIndex<DefaultIx>> changed;
+    std::mt19937 rng;
+    std::uniform_int_distribution<DefaultIx> pick;
+    std::uniform_real_distribution<float> factor;
+};
+
+/// Repairs the tree after each batch of `batch` weight changes.
+void BM_DynamicSsspUpdate(benchmark::State& state)
+{
+    auto const batch = static_cast<std::size_t>(state.range(0));
+    Traffic traffic;
+    DynamicSssp live(traffic.graph, NodeIndex<DefaultIx>(0), edge_weight);
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        traffic.jitter(batch);
+        settled += live.update(traffic.changed.begin(), traffic.changed.end());
+    }
+    state.counters["settled_per_batch"] = benchmark::Counter(static_cast<double>(settled), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+/// The baseline: a full search after each batch of changes.
+void BM_DynamicSsspRecompute(benchmark::State& state)
+{
+    auto const batch = static_cast<std::size_t>(state.range(0));
+    Traffic traffic;
+    SearchWorkspace<DefaultIx, float> ws;
+    for (auto _ : state) {
+        traffic.jitter(batch);
+        dijkstra(traffic.graph, NodeIndex<DefaultIx>(0), edge_weight, ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+}
+
+BENCHMARK(BM_DynamicSsspUpdate)->ArgName("batch")->Arg(1)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DynamicSsspRecompute)->ArgName("batch")->Arg(1)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "graph.hpp"
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+/// Deterministic synthetic graphs for the benchmarks. Every generator takes an
+/// explicit seed so runs are comparable across builds.
+namespace generators {
+
+/// Edge list of an R-MAT power-law graph with `2^scale` nodes and
+/// `edge_factor` edges per node, using the Graph500 partition probabilities.
+template <typename Ix, typename E>
+std::vector<std::tuple<Ix, Ix, E>> rmat_edges(unsigned scale, std::size_t edge_factor, unsigned seed = 1)
+{
+    std::size_t const n = std::size_t(1) << scale;
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> weight(1, 100);
+    double const a = 0.57, b = 0.19, c = 0.19;
+
+    std::vector<std::tuple<Ix, Ix, E>> edges;
+    edges.reserve(n * edge_factor);
+    for (std::size_t i = 0; i < n * edge_factor; ++i) {
+        std::size_t u = 0, v = 0;
+        for (unsigned bit = 0; bit < scale; ++bit) {
+            auto const r = coin(rng);
+            if (r < a) {
+            }
+            else if (r < a + b) {
+                v |= std::size_t(1) << bit;
+            }
+            else if (r < a + b + c) {
+                u |= std::size_t(1) << bit;
+            }
+            else {
+                u |= std::size_t(1) << bit;
+                v |= std::size_t(1) << bit;
+            }
+        }
+        edges.push_back(std::make_tuple(static_cast<Ix>(u), static_cast<Ix>(v), static_cast<E>(weight(rng))));
+    }
+    return edges;
+}
+
+/// Edge list of a `side` x `side` 4-neighbor grid with both directions of
+/// every link and uniform random weights.
+template <typename Ix, typename E>
+std::vector<std::tuple<Ix, Ix, E>> grid_edges(std::size_t side, unsigned seed = 1)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 100);
+
+    std::vector<std::tuple<Ix, Ix, E>> edges;
+    edges.reserve(4 * side * side);
+    auto const link = [&](std::size_t u, std::size_t v) {
+        auto const w = static_cast<E>(weight(rng));
+        edges.push_back(std::make_tuple(static_cast<Ix>(u), static_cast<Ix>(v), w));
+        edges.push_back(std::make_tuple(static_cast<Ix>(v), static_cast<Ix>(u), w));
+    };
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            auto const u = r * side + c;
+            if (c + 1 < side) {
+                link(u, u + 1);
+            }
+            if (r + 1 < side) {
+                link(u, u + side);
+            }
+        }
+    }
+    return edges;
+}
+
+/// Edge list of an Erdős–Rényi G(n, m) graph with `n * average_degree`
+/// directed edges between uniformly chosen endpoints.
+template <typename Ix, typename E>
+std::vector<std::tuple<Ix, Ix, E>> erdos_renyi_edges(std::size_t n, std::size_t average_degree, unsigned seed = 1)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::size_t> node(0, n - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+
+    std::vector<std::tuple<Ix, Ix, E>> edges;
+    edges.reserve(n * average_degree);
+    for (std::size_t i = 0; i < n * average_degree; ++i) {
+        auto const u = static_cast<Ix>(node(rng));
+        auto const v = static_cast<Ix>(node(rng));
+        edges.push_back(std::make_tuple(u, v, static_cast<E>(weight(rng))));
+    }
+    return edges;
+}
+
+/// Edge list of a road-network-like graph: a `side` x `side` grid with a
+/// tenth of its streets removed, travel times that vary per street, and a
+/// sparse lattice of fast highways every 16 blocks. Degrees stay small and
+/// the diameter large, as in real road graphs.
+template <typename Ix, typename E>
+std::vector<std::tuple<Ix, Ix, E>> road_like_edges(std::size_t side, unsigned seed = 1)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> street(10, 40);
+    std::uniform_int_distribution<int> closed(0, 9);
+    std::size_t const block = 16;
+
+    std::vector<std::tuple<Ix, Ix, E>> edges;
+    edges.reserve(4 * side * side);
+    auto const link = [&](std::size_t u, std::size_t v, int w) {
+        edges.push_back(std::make_tuple(static_cast<Ix>(u), static_cast<Ix>(v), static_cast<E>(w)));
+        edges.push_back(std::make_tuple(static_cast<Ix>(v), static_cast<Ix>(u), static_cast<E>(w)));
+    };
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            auto const u = r * side + c;
+            if (c + 1 < side && closed(rng) != 0) {
+                link(u, u + 1, street(rng));
+            }
+            if (r + 1 < side && closed(rng) != 0) {
+                link(u, u + side, street(rng));
+            }
+            if (r % block == 0 && c % block == 0) {
+                if (c + block < side) {
+                    link(u, u + block, 4 * static_cast<int>(block));
+                }
+                if (r + block < side) {
+                    link(u, u + block * side, 4 * static_cast<int>(block));
+                }
+            }
+        }
+    }
+    return edges;
+}
+
+/// Builds a graph with `n` default-weighted nodes by calling add_node and
+/// add_edge, the way an application populates a graph incrementally.
+template <typename G, typename EdgeList>
+G build(EdgeList const& edges, std::size_t n)
+{
+    G graph;
+    graph.reserve_nodes(n);
+    graph.reserve_edges(edges.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        graph.add_node(typename G::node_weight_t());
+    }
+    for (auto const& e : edges) {
+        graph.add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+    }
+    return graph;
+}
+
+/// Adds `2^scale` nodes and the R-MAT edges of rmat_edges() to a new graph.
+template <typename G>
+G rmat(unsigned scale, std::size_t edge_factor, unsigned seed = 1)
+{
+    using Ix = typename G::index_t;
+
+    auto const edges = rmat_edges<Ix, typename G::edge_weight_t>(scale, edge_factor, seed);
+    return build<G>(edges, std::size_t(1) << scale);
+}
+
+}
@@ -0,0 +1,63 @@
+#include "builder.hpp"
+#include "generators.hpp"
+#include "visit/bfsvisit.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// R-MAT graph rebuilt from the shared edge list so every layout holds the
+/// same topology. Weightless layouts drop the third tuple element.
+template <typename G>
+G layout_graph(unsigned scale)
+{
+    using Ix = typename G::index_t;
+
+    auto const edges = generators::rmat_edges<Ix, double>(scale, 16);
+    if constexpr (std::is_same<typename G::edge_weight_t, NoWeight>::value) {
+        std::vector<std::pair<Ix, Ix>> topology;
+        topology.reserve(edges.size());
+        for (auto const& e : edges) {
+            topology.emplace_back(std::get<0>(e), std::get<1>(e));
+        }
+        return from_edges<G>(topology, std::size_t(1) << scale);
+    }
+    else {
+        return from_edges<G>(edges, std::size_t(1) << scale);
+    }
+}
+
+/// Topology-only traversal: BFS touches links but never weights, which is
+/// exactly the access pattern the compact layouts are meant to speed up.
+template <typename G>
+void BM_TopologyBfs(benchmark::State& state)
+{
+    using Ix = typename G::index_t;
+
+    auto const graph = layout_graph<G>(static_cast<unsigned>(state.range(0)));
+    SearchWorkspace<Ix, Ix> ws;
+    for (auto _ : state) {
+        breadth_first_search(graph, NodeIndex<Ix>(0), ws);
+        benchmark::DoNotOptimize(ws.frontier.size());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+    // Bytes per edge the BFS streams through: SoA keeps the links in their
+    // own array, AoS drags each edge's weight along with its links.
+    constexpr auto edge_bytes = std::is_same<typename G::storage_t, SoaStorage>::value ? sizeof(EdgeLinks<Ix>)
+                                                                                        : sizeof(Edge<typename G::edge_weight_t, Ix>);
+    state.counters["edge_bytes"] = static_cast<double>(edge_bytes);
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_TopologyBfs, DiGraph<int, double>)->Arg(11)->Arg(16);
+BENCHMARK_TEMPLATE(BM_TopologyBfs, DiGraph<int, double, DefaultIx, SoaStorage>)->Arg(11)->Arg(16);
+BENCHMARK_TEMPLATE(BM_TopologyBfs, DiGraph<int, void>)->Arg(11)->Arg(16);
+// 16-bit indices cap the graph at 65535 edges.
+BENCHMARK_TEMPLATE(BM_TopologyBfs, DiGraph<int, void, std::uint16_t>)->Arg(11);
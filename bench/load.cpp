@@ -0,0 +1,81 @@
+#include "builder.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using EdgeList = std::vector<std::tuple<DefaultIx, DefaultIx, float>>;
+
+EdgeList const& edge_list(unsigned scale)
+{
+    static std::vector<EdgeList> cache(32);
+    if (cache[scale].empty()) {
+        cache[scale] = generators::rmat_edges<DefaultIx, float>(scale, 16);
+    }
+    return cache[scale];
+}
+
+void BM_LoadIncremental(benchmark::State& state)
+{
+    auto const& edges = edge_list(state.range(0));
+    std::size_t const n = std::size_t(1) << state.range(0);
+    for (auto _ : state) {
+        BenchGraph graph;
+        for (std::size_t i = 0; i < n; ++i) {
+            graph.add_node(0);
+        }
+        for (auto const& e : edges) {
+            graph.add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        }
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_LoadIncrementalReserved(benchmark::State& state)
+{
+    auto const& edges = edge_list(state.range(0));
+    std::size_t const n = std::size_t(1) << state.range(0);
+    for (auto _ : state) {
+        BenchGraph graph(n, edges.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            graph.add_node(0);
+        }
+        for (auto const& e : edges) {
+            graph.add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        }
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_LoadFromEdges(benchmark::State& state)
+{
+    auto const& edges = edge_list(state.range(0));
+    for (auto _ : state) {
+        auto const graph = from_edges<BenchGraph>(edges, std::size_t(1) << state.range(0));
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+void BM_LoadFromEdgesParallel(benchmark::State& state)
+{
+    auto const& edges = edge_list(state.range(0));
+    ThreadPool pool(state.range(1));
+    for (auto _ : state) {
+        auto const graph = from_edges<BenchGraph>(edges, std::size_t(1) << state.range(0), pool);
+        benchmark::DoNotOptimize(graph.edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+}
+
+BENCHMARK(BM_LoadIncremental)->Arg(16)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadIncrementalReserved)->Arg(16)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadFromEdges)->Arg(16)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadFromEdgesParallel)->Args({20, 2})->Args({20, 4})->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,113 @@
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/point_to_point.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+std::size_t const side = 256;
+
+/// Grid and road-like graphs of the core suite; the first argument picks one.
+/// Both lay node `r * side + c` out at row `r`, column `c`, and `min_cost` is
+/// the smallest cost of moving one block, which keeps the Manhattan
+/// heuristic consistent.
+struct Network
+{
+    BenchGraph graph;
+    float min_cost;
+};
+
+Network const& network(long road_like)
+{
+    static Network const grid{generators::build<BenchGraph>(generators::grid_edges<DefaultIx, float>(side), side * side), 1.0f};
+    static Network const road{generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side), 4.0f};
+    return road_like ? road : grid;
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Fixed sequence of random query pairs, shared by every variant.
+std::pair<NodeIndex<DefaultIx>, NodeIndex<DefaultIx>> query(std::mt19937& rng)
+{
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(side * side - 1));
+    auto const s = pick(rng);
+    return std::make_pair(NodeIndex<DefaultIx>(s), NodeIndex<DefaultIx>(pick(rng)));
+}
+
+void report(benchmark::State& state, std::size_t settled)
+{
+    state.counters["settled_per_query"] = static_cast<double>(settled) / state.iterations();
+    state.SetLabel(state.range(0) ? "road_like" : "grid");
+}
+
+void BM_PointToPointDijkstra(benchmark::State& state)
+{
+    auto const& net = network(state.range(0));
+    SearchWorkspace<DefaultIx, float> ws;
+    std::mt19937 rng(5);
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        auto const q = query(rng);
+        dijkstra(net.graph, q.first, edge_weight, ws, q.second);
+        benchmark::DoNotOptimize(ws.distance_to(q.second));
+        state.PauseTiming();
+        for (std::size_t v = 0; v < net.graph.node_count(); ++v) {
+            settled += ws.mark_of(NodeIndex<DefaultIx>(static_cast<DefaultIx>(v))) == SearchWorkspace<DefaultIx, float>::Done;
+        }
+        state.ResumeTiming();
+    }
+    report(state, settled);
+}
+
+void BM_PointToPointBidirectional(benchmark::State& state)
+{
+    auto const& net = network(state.range(0));
+    BidirectionalWorkspace<DefaultIx, float> ws;
+    std::mt19937 rng(5);
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        auto const q = query(rng);
+        auto const path = bidirectional_dijkstra(net.graph, q.first, q.second, edge_weight, ws);
+        benchmark::DoNotOptimize(path.distance);
+        settled += path.settled;
+    }
+    report(state, settled);
+}
+
+void BM_PointToPointAstar(benchmark::State& state)
+{
+    auto const& net = network(state.range(0));
+    SearchWorkspace<DefaultIx, float> ws;
+    std::mt19937 rng(5);
+    std::size_t settled = 0;
+    for (auto _ : state) {
+        auto const q = query(rng);
+        auto const tr = static_cast<long>(q.second.index() / side);
+        auto const tc = static_cast<long>(q.second.index() % side);
+        auto const manhattan = [&](NodeIndex<DefaultIx> v) {
+            auto const r = static_cast<long>(v.index() / side);
+            auto const c = static_cast<long>(v.index() % side);
+            return net.min_cost * static_cast<float>(std::labs(r - tr) + std::labs(c - tc));
+        };
+        auto const path = astar(net.graph, q.first, q.second, edge_weight, manhattan, ws);
+        benchmark::DoNotOptimize(path.distance);
+        settled += path.settled;
+    }
+    report(state, settled);
+}
+
+}
+
+BENCHMARK(BM_PointToPointDijkstra)->ArgName("road_like")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PointToPointBidirectional)->ArgName("road_like")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PointToPointAstar)->ArgName("road_like")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
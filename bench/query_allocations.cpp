@@ -0,0 +1,89 @@
+#include "algorithms/dijkstra.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count(0);
+
+}
+
+// Both sides use malloc/free and stay out of line. If GCC inlines only one
+// of them, it sees malloc paired with operator delete, or operator new with
+// free, and warns (-Wmismatched-new-delete).
+
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+DiGraph<int, float> road_like(std::size_t side)
+{
+    return generators::build<DiGraph<int, float>>(generators::road_like_edges<DefaultIx, float>(side), side * side);
+}
+
+float edge_weight(DiGraph<int, float>::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Short point-to-point queries, where per-query bookkeeping dominates.
+void BM_DijkstraFreshResult(benchmark::State& state)
+{
+    auto const graph = road_like(state.range(0));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(graph.node_count() - 1));
+
+    auto const before = allocation_count.load();
+    for (auto _ : state) {
+        auto const s = pick(rng);
+        auto const result = dijkstra(graph, s, edge_weight, NodeIndex<DefaultIx>(s ^ 1));
+        benchmark::DoNotOptimize(result.distance.data());
+    }
+    state.counters["allocs_per_query"] = static_cast<double>(allocation_count.load() - before) / state.iterations();
+}
+
+void BM_DijkstraWorkspace(benchmark::State& state)
+{
+    auto const graph = road_like(state.range(0));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(graph.node_count() - 1));
+    SearchWorkspace<DefaultIx, float> ws;
+    dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight, ws);
+
+    auto const before = allocation_count.load();
+    for (auto _ : state) {
+        auto const s = pick(rng);
+        dijkstra(graph, s, edge_weight, ws, NodeIndex<DefaultIx>(s ^ 1));
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.counters["allocs_per_query"] = static_cast<double>(allocation_count.load() - before) / state.iterations();
+}
+
+}
+
+BENCHMARK(BM_DijkstraFreshResult)->Arg(256)->Arg(1024);
+BENCHMARK(BM_DijkstraWorkspace)->Arg(256)->Arg(1024);
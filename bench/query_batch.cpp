@@ -0,0 +1,69 @@
+#include "algorithms/query_batch.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using Batch = QueryBatch<BenchGraph, float>;
+
+std::size_t const side = 256;
+
+BenchGraph const& road_network()
+{
+    static auto const graph = generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side);
+    return graph;
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+std::vector<Batch::query_t> random_queries(std::size_t count)
+{
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(side * side - 1));
+    std::vector<Batch::query_t> queries;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const s = pick(rng);
+        queries.emplace_back(NodeIndex<DefaultIx>(s), NodeIndex<DefaultIx>(pick(rng)));
+    }
+    return queries;
+}
+
+/// Throughput of one batch of point-to-point queries on a shared graph;
+/// with UseRealTime the items rate is queries per wall-clock second.
+void BM_QueryBatchShortestPaths(benchmark::State& state)
+{
+    auto const& graph = road_network();
+    auto const queries = random_queries(256);
+    ThreadPool pool(state.range(0));
+    Batch batch(graph, pool);
+    batch.shortest_paths(queries, edge_weight);
+    for (auto _ : state) {
+        auto const paths = batch.shortest_paths(queries, edge_weight);
+        benchmark::DoNotOptimize(paths.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench)
+{
+    for (long threads : {1L, 2L, 4L}) {
+        bench->Arg(threads);
+    }
+    auto const all = static_cast<long>(ThreadPool::default_size());
+    if (all > 4) {
+        bench->Arg(all);
+    }
+}
+
+}
+
+BENCHMARK(BM_QueryBatchShortestPaths)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+#include "visit/bfsvisit.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+/// Road-like graph with 2^scale nodes, the setting where closed roads and
+/// expired links remove a few edges at a time.
+BenchGraph road_graph(long scale)
+{
+    auto const side = std::size_t(1) << (scale / 2);
+    return generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side);
+}
+
+/// Every `stride`-th index in a fixed random order.
+std::vector<DefaultIx> sample(std::size_t count, std::size_t stride)
+{
+    std::vector<DefaultIx> order(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<DefaultIx>(i);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+    order.resize(count / stride);
+    return order;
+}
+
+void BM_RemoveEdge(benchmark::State& state)
+{
+    auto const original = road_graph(state.range(0));
+    auto const victims = sample(original.edge_count(), 10);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto graph = original;
+        state.ResumeTiming();
+        for (auto e : victims) {
+            graph.remove_edge(EdgeIndex<DefaultIx>(e));
+        }
+        benchmark::DoNotOptimize(graph.free_edges.data());
+    }
+    state.SetItemsProcessed(state.iterations() * victims.size());
+}
+
+void BM_RemoveNode(benchmark::State& state)
+{
+    auto const original = road_graph(state.range(0));
+    auto const victims = sample(original.node_count(), 10);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto graph = original;
+        state.ResumeTiming();
+        for (auto a : victims) {
+            graph.remove_node(NodeIndex<DefaultIx>(a));
+        }
+        benchmark::DoNotOptimize(graph.free_nodes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * victims.size());
+}
+
+/// Cost of compact() after a tenth of the nodes has been removed.
+void BM_Compact(benchmark::State& state)
+{
+    auto original = road_graph(state.range(0));
+    for (auto a : sample(original.node_count(), 10)) {
+        original.remove_node(NodeIndex<DefaultIx>(a));
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto graph = original;
+        state.ResumeTiming();
+        auto const remap = graph.compact();
+        benchmark::DoNotOptimize(remap.nodes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * original.edge_count());
+}
+
+/// BFS from node 0 after a churn of removals and re-insertions: with the
+/// holes left in place and the reused slots scattered (compacted=0), and
+/// after compact() (compacted=1).
+void BM_BfsAfterChurn(benchmark::State& state)
+{
+    auto graph = road_graph(state.range(0));
+    std::mt19937 rng(5);
+    for (auto e : sample(graph.edge_count(), 4)) {
+        graph.remove_edge(EdgeIndex<DefaultIx>(e));
+    }
+    std::uniform_int_distribution<DefaultIx> pick(0, static_cast<DefaultIx>(graph.node_count() - 1));
+    for (std::size_t i = graph.free_edges.size() / 2; i > 0; --i) {
+        graph.add_edge(NodeIndex<DefaultIx>(pick(rng)), NodeIndex<DefaultIx>(pick(rng)), 1.0f);
+    }
+    if (state.range(1)) {
+        graph.compact();
+    }
+
+    SearchWorkspace<DefaultIx> ws;
+    for (auto _ : state) {
+        breadth_first_search(graph, NodeIndex<DefaultIx>(0), ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.live_edge_count());
+}
+
+}
+
+BENCHMARK(BM_RemoveEdge)->ArgName("scale")->Arg(12)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RemoveNode)->ArgName("scale")->Arg(12)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Compact)->ArgName("scale")->Arg(12)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BfsAfterChurn)->ArgNames({"scale", "compacted"})->Args({16, 0})->Args({16, 1})->Unit(benchmark::kMillisecond);
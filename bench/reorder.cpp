@@ -0,0 +1,136 @@
+#include "algorithms/dijkstra.hpp"
+#include "reorder.hpp"
+#include "visit/bfsvisit.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+
+/// Side of the road-like grid: 2^16 nodes.
+std::size_t const side = 256;
+
+/// Road-like graph whose ids were shuffled, as when nodes arrive in the
+/// order a crawler or an import happened to find them. `original[v]` is the
+/// generator id of node `v`, which gives its grid position.
+struct Shuffled
+{
+    BenchGraph graph;
+    std::vector<DefaultIx> original;
+};
+
+Shuffled const& shuffled()
+{
+    static Shuffled const result = [] {
+        Shuffled s;
+        auto const n = side * side;
+        std::vector<DefaultIx> id(n);
+        std::iota(id.begin(), id.end(), DefaultIx(0));
+        std::shuffle(id.begin(), id.end(), std::mt19937(21));
+        auto edges = generators::road_like_edges<DefaultIx, float>(side);
+        for (auto& e : edges) {
+            std::get<0>(e) = id[std::get<0>(e)];
+            std::get<1>(e) = id[std::get<1>(e)];
+        }
+        s.graph = generators::build<BenchGraph>(edges, n);
+        s.original.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            s.original[id[i]] = static_cast<DefaultIx>(i);
+        }
+        return s;
+    }();
+    return result;
+}
+
+/// The shuffled graph reordered by strategy `order`, with 0 meaning no
+/// reordering and 1 + NodeOrder otherwise, and the new index of its node 0.
+std::pair<BenchGraph const*, NodeIndex<DefaultIx>> ordered(long order)
+{
+    static std::map<long, std::pair<BenchGraph, NodeIndex<DefaultIx>>> cache;
+    auto const& s = shuffled();
+    if (order == 0) {
+        return {&s.graph, NodeIndex<DefaultIx>(0)};
+    }
+    auto it = cache.find(order);
+    if (it == cache.end()) {
+        auto graph = s.graph;
+        auto const position = [&](NodeIndex<DefaultIx> v) {
+            auto const id = s.original[v.index()];
+            return std::make_pair(id % side, id / side);
+        };
+        auto const map = reorder(graph, static_cast<NodeOrder>(order - 1), position);
+        it = cache.emplace(order, std::make_pair(std::move(graph), map.to_new(NodeIndex<DefaultIx>(0)))).first;
+    }
+    return {&it->second.first, it->second.second};
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+void BM_ReorderBuild(benchmark::State& state)
+{
+    auto const& s = shuffled();
+    auto const position = [&](NodeIndex<DefaultIx> v) {
+        auto const id = s.original[v.index()];
+        return std::make_pair(id % side, id / side);
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto graph = s.graph;
+        state.ResumeTiming();
+        auto const map = reorder(graph, static_cast<NodeOrder>(state.range(0) - 1), position);
+        benchmark::DoNotOptimize(map.old_to_new.data());
+    }
+    state.SetItemsProcessed(state.iterations() * s.graph.edge_count());
+}
+
+void BM_ReorderBfs(benchmark::State& state)
+{
+    auto const target = ordered(state.range(0));
+    SearchWorkspace<DefaultIx> ws;
+    for (auto _ : state) {
+        breadth_first_search(*target.first, target.second, ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * target.first->edge_count());
+}
+
+void BM_ReorderDijkstra(benchmark::State& state)
+{
+    auto const target = ordered(state.range(0));
+    DijkstraResult<DefaultIx, float> result;
+    for (auto _ : state) {
+        dijkstra(*target.first, target.second, edge_weight, result);
+        benchmark::DoNotOptimize(result.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * target.first->edge_count());
+}
+
+/// order=0 is the shuffled graph; 1..4 are reverse Cuthill-McKee, BFS,
+/// degree and Hilbert order.
+void orders(benchmark::internal::Benchmark* bench, long first)
+{
+    bench->ArgName("order");
+    for (long order = first; order <= 4; ++order) {
+        bench->Arg(order);
+    }
+}
+
+}
+
+BENCHMARK(BM_ReorderBuild)->Apply([](benchmark::internal::Benchmark* b) { orders(b, 1); })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReorderBfs)->Apply([](benchmark::internal::Benchmark* b) { orders(b, 0); })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReorderDijkstra)->Apply([](benchmark::internal::Benchmark* b) { orders(b, 0); })->Unit(benchmark::kMillisecond);
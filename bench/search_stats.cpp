@@ -0,0 +1,149 @@
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/search_stats.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using Event = DfsEvent<NodeIndex<DefaultIx>>;
+
+/// Road-like graph with 2^16 nodes.
+BenchGraph const& network()
+{
+    static BenchGraph const graph = generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(256), 256 * 256);
+    return graph;
+}
+
+float edge_weight(BenchGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Sums query times, standing in for a metrics exporter.
+struct TotalTime
+{
+    void operator()(SearchTrace const& trace)
+    {
+        *total += trace.elapsed;
+    }
+
+    std::chrono::steady_clock::duration* total;
+};
+
+using Traced = TracedStats<TotalTime>;
+
+/// A fresh policy of type `S`; TracedStats needs its hook.
+template <typename S>
+struct Policy
+{
+    S stats;
+};
+
+template <>
+struct Policy<Traced>
+{
+    std::chrono::steady_clock::duration total{};
+    Traced stats{TotalTime{&total}};
+};
+
+// The *Plain variants call the overloads without a stats argument. They and
+// the NoStats instantiations must run at the same speed, and both at the
+// speed of BM_Dijkstra/BM_Dfs in bench/baseline.json on the reference
+// machine.
+
+void BM_StatsBfsPlain(benchmark::State& state)
+{
+    auto const& graph = network();
+    SearchWorkspace<DefaultIx> ws;
+    for (auto _ : state) {
+        breadth_first_search(graph, NodeIndex<DefaultIx>(0), ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+template <typename S>
+void BM_StatsBfs(benchmark::State& state)
+{
+    auto const& graph = network();
+    SearchWorkspace<DefaultIx> ws;
+    Policy<S> policy;
+    for (auto _ : state) {
+        breadth_first_search(graph, NodeIndex<DefaultIx>(0), ws, NodeIndex<DefaultIx>::end(), policy.stats);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void BM_StatsDfsPlain(benchmark::State& state)
+{
+    auto const& graph = network();
+    DfsWorkspace<BenchGraph> ws;
+    std::size_t finished = 0;
+    for (auto _ : state) {
+        depth_first_search(graph, NodeIndex<DefaultIx>(0), [&](Event const& event) { finished += event.kind == Event::Kind::Finish; }, ws);
+    }
+    benchmark::DoNotOptimize(finished);
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+template <typename S>
+void BM_StatsDfs(benchmark::State& state)
+{
+    auto const& graph = network();
+    DfsWorkspace<BenchGraph> ws;
+    Policy<S> policy;
+    std::size_t finished = 0;
+    for (auto _ : state) {
+        depth_first_search(graph, NodeIndex<DefaultIx>(0), [&](Event const& event) { finished += event.kind == Event::Kind::Finish; }, ws,
+                           policy.stats);
+    }
+    benchmark::DoNotOptimize(finished);
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+void BM_StatsDijkstraPlain(benchmark::State& state)
+{
+    auto const& graph = network();
+    SearchWorkspace<DefaultIx, float> ws;
+    for (auto _ : state) {
+        dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight, ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+template <typename S>
+void BM_StatsDijkstra(benchmark::State& state)
+{
+    auto const& graph = network();
+    SearchWorkspace<DefaultIx, float> ws;
+    Policy<S> policy;
+    for (auto _ : state) {
+        dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight, ws, NodeIndex<DefaultIx>::end(), policy.stats);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+}
+
+BENCHMARK(BM_StatsBfsPlain)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsBfs, NoStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsBfs, SearchStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsBfs, Traced)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StatsDfsPlain)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDfs, NoStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDfs, SearchStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDfs, Traced)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StatsDijkstraPlain)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDijkstra, NoStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDijkstra, SearchStats)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StatsDijkstra, Traced)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,80 @@
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/shortest_paths.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using Edge = BenchGraph::edge_reference_t;
+
+/// Road-like graph with 2^16 nodes. Its costs are whole numbers below 128,
+/// so every cost type below sees the same graph.
+BenchGraph const& network()
+{
+    static BenchGraph const graph = generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(256), 256 * 256);
+    return graph;
+}
+
+/// Edge costs as type `T`; NoWeight means one hop per edge.
+template <typename T>
+T cost_as(Edge const& e)
+{
+    if constexpr (std::is_empty<T>::value) {
+        return T();
+    }
+    else {
+        return static_cast<T>(e.weight());
+    }
+}
+
+/// Comparison-heap baseline: dijkstra() on costs of type `T`, with unit
+/// costs spelled as 1 and 8-bit costs widened so the sums do not overflow.
+template <typename T>
+void BM_CostHeap(benchmark::State& state)
+{
+    using D = cost_distance_t<T>;
+    auto const& graph = network();
+    SearchWorkspace<DefaultIx, D> ws;
+    auto const weight = [](Edge const& e) {
+        if constexpr (std::is_empty<T>::value) {
+            return D(1);
+        }
+        else {
+            return static_cast<D>(cost_as<T>(e));
+        }
+    };
+    for (auto _ : state) {
+        dijkstra(graph, NodeIndex<DefaultIx>(0), weight, ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+/// The kernel shortest_paths() picks for `T`.
+template <typename T>
+void BM_CostDispatch(benchmark::State& state)
+{
+    auto const& graph = network();
+    ShortestPathWorkspace<DefaultIx, T> ws;
+    for (auto _ : state) {
+        shortest_paths(graph, NodeIndex<DefaultIx>(0), cost_as<T>, ws);
+        benchmark::DoNotOptimize(ws.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations() * graph.edge_count());
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_CostHeap, NoWeight)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostDispatch, NoWeight)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostHeap, std::uint8_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostDispatch, std::uint8_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostHeap, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostDispatch, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostHeap, double)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CostDispatch, double)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,154 @@
+#include "versioned_graph.hpp"
+
+#include "generators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using BenchGraph = DiGraph<int, float>;
+using Versioned = VersionedGraph<int, float>;
+
+constexpr std::size_t side = 128;
+constexpr std::size_t batch_size = 256;
+
+BenchGraph network()
+{
+    return generators::build<BenchGraph>(generators::road_like_edges<DefaultIx, float>(side), side * side);
+}
+
+/// The reader's query: total cost of the two-hop neighbourhood of `u`.
+template <typename G>
+float two_hop_cost(G const& graph, NodeIndex<DefaultIx> u)
+{
+    float total = 0;
+    for (auto const& e : graph.edges_of(u)) {
+        total += e.weight();
+        for (auto const& f : graph.edges_of(e.target())) {
+            total += f.weight();
+        }
+    }
+    return total;
+}
+
+/// Runs `batch` in a loop on a background thread until destroyed, standing
+/// in for a writer applying a stream of travel-time updates.
+struct BackgroundWriter
+{
+    template <typename F>
+    BackgroundWriter(bool enabled, F batch)
+    {
+        if (enabled) {
+            thread = std::thread([this, batch]() mutable {
+                std::mt19937 rng(5);
+                while (!stop.load(std::memory_order_relaxed)) {
+                    batch(rng);
+                    batches.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            });
+        }
+    }
+
+    ~BackgroundWriter()
+    {
+        stop.store(true);
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> batches{0};
+    std::thread thread;
+};
+
+/// Times every query and reports the mean and the 99th percentile.
+template <typename Query>
+void time_queries(benchmark::State& state, Query query, std::atomic<std::size_t> const& batches)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::size_t> node(0, side * side - 1);
+    std::vector<double> latencies;
+    float sink = 0;
+    for (auto _ : state) {
+        auto const start = std::chrono::steady_clock::now();
+        sink += query(NodeIndex<DefaultIx>(node(rng)));
+        latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    benchmark::DoNotOptimize(sink);
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_ns"] = latencies[latencies.size() / 2];
+    state.counters["p99_ns"] = latencies[latencies.size() * 99 / 100];
+    state.counters["batches"] = static_cast<double>(batches.load());
+}
+
+// Arg(0) reads an idle graph, Arg(1) reads while a writer rewrites batches of
+// edge weights as fast as it can. Snapshot readers should keep the same latency
+// under write load; readers sharing a lock with the writer wait for whole
+// batches once reader and writer run on separate cores.
+
+void BM_VersionedRead(benchmark::State& state)
+{
+    Versioned graph(network());
+    auto const reader = graph.reader();
+    std::uniform_int_distribution<std::size_t> edge(0, graph.latest().edge_count() - 1);
+    BackgroundWriter writer(state.range(0) != 0, [&](std::mt19937& rng) {
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            graph.set_edge_weight(EdgeIndex<DefaultIx>(edge(rng)), static_cast<float>(10 + rng() % 30));
+        }
+        graph.publish();
+    });
+    time_queries(state, [&](NodeIndex<DefaultIx> u) { return two_hop_cost(*reader.pin(), u); }, writer.batches);
+}
+
+void BM_LockedRead(benchmark::State& state)
+{
+    auto graph = network();
+    std::shared_mutex lock;
+    std::uniform_int_distribution<std::size_t> edge(0, graph.edge_count() - 1);
+    BackgroundWriter writer(state.range(0) != 0, [&](std::mt19937& rng) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            graph.edge_weight(EdgeIndex<DefaultIx>(edge(rng))) = static_cast<float>(10 + rng() % 30);
+        }
+    });
+    time_queries(
+        state,
+        [&](NodeIndex<DefaultIx> u) {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            return two_hop_cost(graph, u);
+        },
+        writer.batches);
+}
+
+/// Writer cost of one published batch of weight updates, chunk copies
+/// included.
+void BM_VersionedPublish(benchmark::State& state)
+{
+    Versioned graph(network());
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<std::size_t> edge(0, graph.latest().edge_count() - 1);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            graph.set_edge_weight(EdgeIndex<DefaultIx>(edge(rng)), static_cast<float>(10 + rng() % 30));
+        }
+        graph.publish();
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+}
+
+BENCHMARK(BM_VersionedRead)->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_LockedRead)->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_VersionedPublish)->Unit(benchmark::kMicrosecond);
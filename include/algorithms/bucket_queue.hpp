@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/// Dial's bucket queue for a shortest-path search with integer edge costs in
+/// `[0, Span)`: one bucket per priority, used circularly, since queued
+/// priorities always lie within `[current, current + Span)`. push and pop
+/// are O(1) amortized, plus the empty buckets pop walks past. There is no
+/// decrease-key: a key is pushed again instead, and the search skips
+/// entries whose priority no longer matches the key's distance.
+template <typename K, typename P, std::size_t Span, typename Alloc = std::allocator<char>>
+struct DialQueue
+{
+    static_assert(std::is_integral<P>::value, "Dial's queue needs integer priorities");
+
+    struct Entry
+    {
+        P priority;
+        K key;
+    };
+
+    using entry_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+    using bucket_t = std::vector<Entry, entry_allocator_t>;
+    using bucket_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<bucket_t>;
+
+    DialQueue()
+    : buckets(Span)
+    {
+    }
+
+    explicit DialQueue(Alloc const& alloc)
+    : buckets(Span, bucket_t(entry_allocator_t(alloc)), bucket_allocator_t(alloc))
+    {
+    }
+
+    void clear()
+    {
+        if (count != 0) {
+            for (auto& bucket : buckets) {
+                bucket.clear();
+            }
+        }
+        current = P();
+        count = 0;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    void push(K key, P priority)
+    {
+        assert(!(priority < current) && priority - current < P(Span) && "priority outside the queue's window");
+        buckets[static_cast<std::size_t>(priority) % Span].push_back(Entry{priority, key});
+        ++count;
+    }
+
+    Entry pop()
+    {
+        assert(count != 0);
+        auto* bucket = &buckets[static_cast<std::size_t>(current) % Span];
+        while (bucket->empty()) {
+            ++current;
+            bucket = &buckets[static_cast<std::size_t>(current) % Span];
+        }
+        auto const result = bucket->back();
+        bucket->pop_back();
+        --count;
+        return result;
+    }
+
+    std::vector<bucket_t, bucket_allocator_t> buckets;
+    P current = P();
+    std::size_t count = 0;
+};
+
+/// Radix heap: bucket `i > 0` holds the entries whose priority first differs
+/// from the last popped one in bit `i - 1`, bucket 0 those equal to it. A pop
+/// from an empty bucket 0 redistributes the lowest non-empty bucket into
+/// smaller ones, so each entry moves at most once per bit: O(log C)
+/// amortized per entry for costs up to C, and any non-negative integer
+/// priority type works. Stale entries are handled as in DialQueue.
+template <typename K, typename P, typename Alloc = std::allocator<char>>
+struct RadixHeap
+{
+    static_assert(std::is_integral<P>::value, "radix heaps need integer priorities");
+
+    using U = typename std::make_unsigned<P>::type;
+
+    struct Entry
+    {
+        P priority;
+        K key;
+    };
+
+    static constexpr std::size_t bucket_count = std::numeric_limits<U>::digits + 1;
+
+    using entry_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+    using bucket_t = std::vector<Entry, entry_allocator_t>;
+    using bucket_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<bucket_t>;
+
+    RadixHeap()
+    : buckets(bucket_count)
+    {
+    }
+
+    explicit RadixHeap(Alloc const& alloc)
+    : buckets(bucket_count, bucket_t(entry_allocator_t(alloc)), bucket_allocator_t(alloc))
+    {
+    }
+
+    void clear()
+    {
+        if (count != 0) {
+            for (auto& bucket : buckets) {
+                bucket.clear();
+            }
+        }
+        last = P();
+        count = 0;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    void push(K key, P priority)
+    {
+        assert(!(priority < last) && "radix heap priorities must not go below the last pop");
+        buckets[bucket_of(priority)].push_back(Entry{priority, key});
+        ++count;
+    }
+
+    Entry pop()
+    {
+        assert(count != 0);
+        if (buckets[0].empty()) {
+            std::size_t i = 1;
+            while (buckets[i].empty()) {
+                ++i;
+            }
+            auto& source = buckets[i];
+            auto smallest = source.front().priority;
+            for (auto const& entry : source) {
+                smallest = entry.priority < smallest ? entry.priority : smallest;
+            }
+            last = smallest;
+            for (auto const& entry : source) {
+                buckets[bucket_of(entry.priority)].push_back(entry);
+            }
+            source.clear();
+        }
+        auto const result = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return result;
+    }
+
+    std::vector<bucket_t, bucket_allocator_t> buckets;
+    P last = P();
+    std::size_t count = 0;
+
+private:
+    std::size_t bucket_of(P priority) const
+    {
+        auto const diff = static_cast<unsigned long long>(static_cast<U>(priority) ^ static_cast<U>(last));
+        return diff == 0 ? 0 : static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits - __builtin_clzll(diff));
+    }
+};
+
+template <typename K, typename P, typename Alloc>
+constexpr std::size_t RadixHeap<K, P, Alloc>::bucket_count;
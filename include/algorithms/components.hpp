@@ -0,0 +1,394 @@
+#pragma once
+
+#include "graph.hpp"
+#include "parallel/thread_pool.hpp"
+#include "visit/dfsvisit.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// Component of every node, as dense ids in `[0, count)` indexed by
+/// NodeIndex::index(). Vacant node slots of a Graph count as isolated nodes;
+/// compact() first to leave them out.
+template <typename Ix>
+struct ComponentMap
+{
+    static Ix none()
+    {
+        return std::numeric_limits<Ix>::max();
+    }
+
+    Ix component_of(NodeIndex<Ix> v) const
+    {
+        return component_id[v.index()];
+    }
+
+    std::vector<Ix> component_id;
+    std::size_t count = 0;
+};
+
+/// Lock-free disjoint sets over `[0, n)`. A root is always the smallest
+/// element of its set: unite() links the larger root below the smaller one
+/// with a compare-and-swap, and find() halves paths with compare-and-swap
+/// too, so parents only ever point to smaller indices and any number of
+/// threads may call both at once.
+template <typename Ix>
+struct ConcurrentUnionFind
+{
+    explicit ConcurrentUnionFind(std::size_t n)
+    : parent(n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            parent[i].store(static_cast<Ix>(i), std::memory_order_relaxed);
+        }
+    }
+
+    Ix find(Ix x)
+    {
+        while (true) {
+            auto p = parent[x].load(std::memory_order_relaxed);
+            if (p == x) {
+                return x;
+            }
+            auto const grandparent = parent[p].load(std::memory_order_relaxed);
+            if (grandparent != p) {
+                parent[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    /// Merges the sets of `a` and `b`; returns false if they were one set.
+    bool unite(Ix a, Ix b)
+    {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return false;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            auto expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    std::vector<std::atomic<Ix>> parent;
+};
+
+namespace detail {
+
+/// Numbers components by their smallest node: `label[i]` names any node of
+/// i's component, the same one for the whole component.
+template <typename Ix, typename Label>
+ComponentMap<Ix> dense_components(std::size_t n, Label&& label)
+{
+    ComponentMap<Ix> result;
+    result.component_id.assign(n, ComponentMap<Ix>::none());
+    std::vector<Ix> dense(n, ComponentMap<Ix>::none());
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& id = dense[label(i)];
+        if (id == ComponentMap<Ix>::none()) {
+            id = static_cast<Ix>(result.count++);
+        }
+        result.component_id[i] = id;
+    }
+    return result;
+}
+
+/// Parallel frontier expansion along `dir`. `admit(v, from)` must claim `v`
+/// atomically and return true only for the one call that claimed it;
+/// claimed nodes form the next frontier. Leaves `frontier` empty.
+template <typename G, typename Admit>
+void parallel_reach(G const& graph, ThreadPool& pool, std::vector<NodeIndex<typename G::index_t>>& frontier,
+                    Direction::Direction dir, std::size_t grain, Admit&& admit)
+{
+    using Ix = typename G::index_t;
+
+    std::vector<std::vector<NodeIndex<Ix>>> local(pool.size());
+    while (!frontier.empty()) {
+        pool.parallel_for(0, frontier.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                auto const u = frontier[i];
+                for (auto const& edge : graph.edges_directed(u, dir)) {
+                    auto const v = dir == Direction::Direction::Outgoing ? edge.target() : edge.source();
+                    if (admit(v, u)) {
+                        local[id].push_back(v);
+                    }
+                }
+            }
+        });
+        frontier.clear();
+        for (auto& mine : local) {
+            frontier.insert(frontier.end(), mine.begin(), mine.end());
+            mine.clear();
+        }
+    }
+}
+
+}
+
+/// Connected components, computed with a ConcurrentUnionFind over every
+/// edge, in parallel on `pool` with nodes handed out in chunks of `grain`.
+/// For directed graphs these are the weakly connected components. Ids are
+/// numbered in order of each component's smallest node.
+template <typename G>
+ComponentMap<typename G::index_t> connected_components(G const& graph, ThreadPool& pool, std::size_t grain = 256)
+{
+    using Ix = typename G::index_t;
+
+    auto const n = graph.node_count();
+    ConcurrentUnionFind<Ix> sets(n);
+    pool.parallel_for(0, n, grain, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto u = first; u < last; ++u) {
+            for (auto const& edge : graph.edges_of(NodeIndex<Ix>(static_cast<Ix>(u)))) {
+                // Undirected graphs list every edge at both ends; uniting at
+                // the smaller one is enough.
+                auto const v = edge.target().index();
+                if (graph.is_directed() || u < v) {
+                    sets.unite(static_cast<Ix>(u), static_cast<Ix>(v));
+                }
+            }
+        }
+    });
+    return detail::dense_components<Ix>(n, [&](std::size_t i) { return sets.find(static_cast<Ix>(i)); });
+}
+
+template <typename G>
+ComponentMap<typename G::index_t> connected_components(G const& graph)
+{
+    ThreadPool pool(1);
+    return connected_components(graph, pool);
+}
+
+/// Strongly connected components by Tarjan's algorithm on the iterative
+/// depth_first_search, so depth is bounded by memory rather than by the call
+/// stack. Ids come out in reverse topological order of the condensation: an
+/// edge between two components always leads to one with a smaller id.
+template <typename G>
+ComponentMap<typename G::index_t> strongly_connected_components(G const& graph)
+{
+    using Ix = typename G::index_t;
+    using Event = DfsEvent<NodeIndex<Ix>>;
+
+    auto const n = graph.node_count();
+    auto const none = ComponentMap<Ix>::none();
+    ComponentMap<Ix> result;
+    result.component_id.assign(n, none);
+    std::vector<Ix> order(n);
+    std::vector<Ix> low(n);
+    std::vector<NodeIndex<Ix>> open;
+    Ix discovered = 0;
+
+    std::vector<NodeIndex<Ix>> starts(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        starts[i] = NodeIndex<Ix>(static_cast<Ix>(i));
+    }
+    DfsWorkspace<G> ws;
+    depth_first_search(graph, starts, [&](Event const& event) {
+        switch (event.kind) {
+        case Event::Kind::Discover: {
+            auto const u = event.discover.source.index();
+            order[u] = low[u] = discovered++;
+            open.push_back(event.discover.source);
+            break;
+        }
+        case Event::Kind::BackEdge: {
+            auto const u = event.back_edge.source.index();
+            low[u] = std::min(low[u], order[event.back_edge.target.index()]);
+            break;
+        }
+        case Event::Kind::CrossForwardEdge: {
+            auto const u = event.cross_forward_edge.source.index();
+            auto const v = event.cross_forward_edge.target.index();
+            if (result.component_id[v] == none) {
+                low[u] = std::min(low[u], order[v]);
+            }
+            break;
+        }
+        case Event::Kind::Finish: {
+            auto const u = event.finish.source;
+            if (low[u.index()] == order[u.index()]) {
+                auto const id = static_cast<Ix>(result.count++);
+                NodeIndex<Ix> w;
+                do {
+                    w = open.back();
+                    open.pop_back();
+                    result.component_id[w.index()] = id;
+                } while (w != u);
+            }
+            // The frame of u is already popped, so the top one is its parent.
+            if (!ws.stack.empty()) {
+                auto const p = ws.stack.back().node.index();
+                low[p] = std::min(low[p], low[u.index()]);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }, ws);
+    return result;
+}
+
+/// Parallel strongly connected components for graphs too large for one core,
+/// run on `pool`; needs ingoing edges.
+///
+/// First, nodes without a live predecessor or successor are trimmed off as
+/// singleton components. Then a forward and a backward parallel search from
+/// the node with the most live in- times out-edges carve out its component,
+/// which in real graphs is usually the giant one. The rest is peeled by
+/// coloring rounds: every node takes the largest index that reaches it, by
+/// parallel label propagation, and each node still holding its own index is
+/// the root of a component made of the nodes with its color that reach it
+/// backwards. Each round also trims again and removes at least one
+/// component. Ids are numbered in order of each component's smallest node,
+/// so they differ from the sequential overload's, but the partition is the
+/// same.
+template <typename G>
+ComponentMap<typename G::index_t> strongly_connected_components(G const& graph, ThreadPool& pool, std::size_t grain = 256)
+{
+    using Ix = typename G::index_t;
+    using Nx = NodeIndex<Ix>;
+
+    auto const n = graph.node_count();
+    auto const none = ComponentMap<Ix>::none();
+    auto const out = Direction::Direction::Outgoing;
+    auto const in = Direction::Direction::Ingoing;
+
+    std::vector<std::atomic<Ix>> label(n);
+    std::vector<std::atomic<Ix>> color(n);
+    std::vector<std::atomic<std::uint8_t>> forward(n);
+    std::vector<std::vector<Nx>> local(pool.size());
+    std::vector<Nx> remaining(n);
+    std::vector<Nx> frontier;
+    pool.parallel_for(0, n, 4096, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i) {
+            label[i].store(none, std::memory_order_relaxed);
+            color[i].store(static_cast<Ix>(i), std::memory_order_relaxed);
+            forward[i].store(0, std::memory_order_relaxed);
+            remaining[i] = Nx(static_cast<Ix>(i));
+        }
+    });
+
+    auto const live = [&](Nx v) { return label[v.index()].load(std::memory_order_relaxed) == none; };
+
+    // Keeps the unlabeled nodes of `remaining`, in parallel.
+    auto const filter = [&] {
+        pool.parallel_for(0, remaining.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                if (live(remaining[i])) {
+                    local[id].push_back(remaining[i]);
+                }
+            }
+        });
+        remaining.clear();
+        for (auto& mine : local) {
+            remaining.insert(remaining.end(), mine.begin(), mine.end());
+            mine.clear();
+        }
+    };
+
+    // Counts the live neighbours of `u` along `dir`, ignoring self loops.
+    auto const live_degree = [&](Nx u, Direction::Direction dir) {
+        std::size_t count = 0;
+        for (auto const& edge : graph.edges_directed(u, dir)) {
+            auto const v = dir == out ? edge.target() : edge.source();
+            count += v != u && live(v);
+        }
+        return count;
+    };
+
+    // Labels every node without a live predecessor or successor as its own
+    // component, and returns a node maximising live in- times out-degree.
+    auto const trim = [&] {
+        std::vector<std::pair<std::size_t, Nx>> best(pool.size(), std::make_pair(std::size_t(0), Nx::end()));
+        pool.parallel_for(0, remaining.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                auto const u = remaining[i];
+                auto const score = live_degree(u, in) * live_degree(u, out);
+                if (score == 0) {
+                    label[u.index()].store(static_cast<Ix>(u.index()), std::memory_order_relaxed);
+                }
+                else if (best[id].second == Nx::end() || score > best[id].first) {
+                    best[id] = std::make_pair(score, u);
+                }
+            }
+        });
+        filter();
+        return std::max_element(best.begin(), best.end(), [](auto const& a, auto const& b) {
+            return b.second != Nx::end() && (a.second == Nx::end() || a.first < b.first);
+        })->second;
+    };
+
+    auto const pivot = trim();
+    if (pivot != Nx::end()) {
+        forward[pivot.index()].store(1, std::memory_order_relaxed);
+        frontier.assign(1, pivot);
+        detail::parallel_reach(graph, pool, frontier, out, grain, [&](Nx v, Nx) {
+            return live(v) && forward[v.index()].exchange(1, std::memory_order_relaxed) == 0;
+        });
+        auto const root = static_cast<Ix>(pivot.index());
+        label[pivot.index()].store(root, std::memory_order_relaxed);
+        frontier.assign(1, pivot);
+        detail::parallel_reach(graph, pool, frontier, in, grain, [&](Nx v, Nx) {
+            auto expected = none;
+            return forward[v.index()].load(std::memory_order_relaxed)
+                && label[v.index()].compare_exchange_strong(expected, root, std::memory_order_relaxed);
+        });
+        filter();
+    }
+
+    while (!remaining.empty()) {
+        trim();
+        if (remaining.empty()) {
+            break;
+        }
+        pool.parallel_for(0, remaining.size(), grain, [&](std::size_t first, std::size_t last, std::size_t) {
+            for (auto i = first; i < last; ++i) {
+                color[remaining[i].index()].store(static_cast<Ix>(remaining[i].index()), std::memory_order_relaxed);
+            }
+        });
+
+        // Propagates the largest color forward until nothing changes; a node
+        // re-enters the frontier each time its color grows.
+        frontier = remaining;
+        detail::parallel_reach(graph, pool, frontier, out, grain, [&](Nx v, Nx from) {
+            if (!live(v)) {
+                return false;
+            }
+            auto const c = color[from.index()].load(std::memory_order_relaxed);
+            auto current = color[v.index()].load(std::memory_order_relaxed);
+            while (current < c) {
+                if (color[v.index()].compare_exchange_weak(current, c, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+
+        frontier.clear();
+        for (auto const u : remaining) {
+            if (color[u.index()].load(std::memory_order_relaxed) == u.index()) {
+                label[u.index()].store(static_cast<Ix>(u.index()), std::memory_order_relaxed);
+                frontier.push_back(u);
+            }
+        }
+        detail::parallel_reach(graph, pool, frontier, in, grain, [&](Nx v, Nx from) {
+            auto const c = color[from.index()].load(std::memory_order_relaxed);
+            auto expected = none;
+            return color[v.index()].load(std::memory_order_relaxed) == c
+                && label[v.index()].compare_exchange_strong(expected, c, std::memory_order_relaxed);
+        });
+        filter();
+    }
+
+    return detail::dense_components<Ix>(n, [&](std::size_t i) { return label[i].load(std::memory_order_relaxed); });
+}
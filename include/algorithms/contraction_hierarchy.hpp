@@ -0,0 +1,684 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/point_to_point.hpp"
+#include "algorithms/search_workspace.hpp"
+#include "io/binary.hpp"
+#include "parallel/thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Tuning knobs of contract(). Witness searches give up after settling
+/// `witness_settle_limit` nodes, which may add a few unnecessary shortcuts but
+/// never loses a shortest path. Simulated contractions, which only estimate a
+/// node's priority, use the much cheaper `simulation_settle_limit`. With a
+/// `pool`, each round's independent node set is simulated and contracted in
+/// parallel.
+struct ContractionOptions
+{
+    std::size_t witness_settle_limit = 500;
+    std::size_t simulation_settle_limit = 16;
+    ThreadPool* pool = nullptr;
+};
+
+/// One arc of the frozen hierarchy: the rank of the node it leads to, the
+/// hierarchy edge it stands for, and its cost.
+template <typename Ix, typename W>
+struct ChArc
+{
+    Ix head;
+    Ix id;
+    W weight;
+};
+
+/// A shortcut replaces the two hierarchy edges `first` then `second`.
+template <typename Ix>
+struct ChShortcut
+{
+    Ix first;
+    Ix second;
+};
+
+/// Scratch state of ContractionHierarchy::query(), indexed by rank and
+/// allocated through `Alloc`.
+template <typename Ix, typename W = double, typename Alloc = std::allocator<char>>
+struct ChQueryWorkspace
+{
+    using allocator_type = Alloc;
+
+    ChQueryWorkspace() = default;
+
+    explicit ChQueryWorkspace(Alloc const& alloc)
+    : forward(alloc)
+    , backward(alloc)
+    {
+    }
+
+    SearchWorkspace<Ix, W, Alloc> forward;
+    SearchWorkspace<Ix, W, Alloc> backward;
+};
+
+/// Contraction hierarchy of a directed graph.
+///
+/// Every node has a rank, and every hierarchy edge joins two nodes of
+/// different rank. A hierarchy edge is either an original edge or a shortcut
+/// that stands for two hierarchy edges through a lower-ranked node. Hierarchy edge ids below `original_edge_count` are the
+/// graph's own EdgeIndex values; id `original_edge_count + i` is shortcut `i`.
+///
+/// Nodes are stored in rank order. `up` holds, for each rank, the edges to
+/// higher ranks, and `down` holds the edges arriving from higher ranks, both as
+/// contiguous CSR arrays. A query is then two small upward Dijkstra searches
+/// that touch adjacent memory.
+template <typename Ix, typename W>
+struct ContractionHierarchy
+{
+    using index_t = Ix;
+    using weight_t = W;
+
+    static W infinity()
+    {
+        return std::numeric_limits<W>::max();
+    }
+
+    std::size_t node_count() const
+    {
+        return rank.size();
+    }
+
+    std::size_t shortcut_count() const
+    {
+        return shortcuts.size();
+    }
+
+    /// Shortest path from `source` to `target` as original EdgeIndex values,
+    /// with `settled` counting the nodes both searches settled.
+    template <typename A>
+    ShortestPath<Ix, W> query(NodeIndex<Ix> source, NodeIndex<Ix> target, ChQueryWorkspace<Ix, W, A>& ws) const
+    {
+        using Mark = typename SearchWorkspace<Ix, W, A>::Mark;
+
+        ShortestPath<Ix, W> result;
+        auto const n = node_count();
+        ws.forward.begin(n);
+        ws.backward.begin(n);
+        auto const from = NodeIndex<Ix>(rank[source.index()]);
+        auto const to = NodeIndex<Ix>(rank[target.index()]);
+        for (auto* side : {&ws.forward, &ws.backward}) {
+            auto const root = side == &ws.forward ? from : to;
+            side->source = root;
+            side->touch(root);
+            side->distance[root.index()] = W();
+            side->queue.push_or_decrease(static_cast<Ix>(root.index()), W());
+        }
+
+        auto meet = NodeIndex<Ix>::end();
+        while (true) {
+            bool const forward_live = !ws.forward.queue.empty() && ws.forward.queue.top().priority < result.distance;
+            bool const backward_live = !ws.backward.queue.empty() && ws.backward.queue.top().priority < result.distance;
+            if (!forward_live && !backward_live) {
+                break;
+            }
+            bool const forward = forward_live
+                && (!backward_live || !(ws.backward.queue.top().priority < ws.forward.queue.top().priority));
+            auto& self = forward ? ws.forward : ws.backward;
+            auto& other = forward ? ws.backward : ws.forward;
+            auto const& offsets = forward ? up_offsets : down_offsets;
+            auto const& arcs = forward ? up_arcs : down_arcs;
+
+            auto const current = self.queue.pop();
+            auto const u = NodeIndex<Ix>(current.key);
+            self.mark[u.index()] = Mark::Done;
+            ++result.settled;
+            if (other.reachable(u) && current.priority + other.distance[u.index()] < result.distance) {
+                result.distance = current.priority + other.distance[u.index()];
+                meet = u;
+            }
+
+            for (auto i = offsets[u.index()]; i < offsets[u.index() + 1]; ++i) {
+                auto const& arc = arcs[i];
+                auto const v = NodeIndex<Ix>(arc.head);
+                auto const candidate = current.priority + arc.weight;
+                self.touch(v);
+                if (candidate < self.distance[v.index()]) {
+                    self.distance[v.index()] = candidate;
+                    self.parent[v.index()] = u;
+                    self.parent_edge[v.index()] = EdgeIndex<Ix>(arc.id);
+                    self.queue.push_or_decrease(arc.head, candidate);
+                }
+            }
+        }
+
+        if (result.found()) {
+            std::vector<Ix> packed;
+            for (auto u = meet; u != from; u = ws.forward.parent[u.index()]) {
+                packed.push_back(static_cast<Ix>(ws.forward.parent_edge[u.index()].index()));
+            }
+            std::reverse(packed.begin(), packed.end());
+            for (auto u = meet; u != to; u = ws.backward.parent[u.index()]) {
+                packed.push_back(static_cast<Ix>(ws.backward.parent_edge[u.index()].index()));
+            }
+            result.nodes.push_back(source);
+            for (auto const id : packed) {
+                unpack(id, result);
+            }
+        }
+        return result;
+    }
+
+    ShortestPath<Ix, W> query(NodeIndex<Ix> source, NodeIndex<Ix> target) const
+    {
+        ChQueryWorkspace<Ix, W> ws;
+        return query(source, target, ws);
+    }
+
+    /// Rank of each node, and the node holding each rank.
+    std::vector<Ix> rank;
+    std::vector<NodeIndex<Ix>> node_of_rank;
+    std::vector<std::size_t> up_offsets;
+    std::vector<ChArc<Ix, W>> up_arcs;
+    std::vector<std::size_t> down_offsets;
+    std::vector<ChArc<Ix, W>> down_arcs;
+    std::vector<ChShortcut<Ix>> shortcuts;
+    /// Target node of every original edge, for listing the nodes of a path.
+    std::vector<NodeIndex<Ix>> edge_heads;
+
+private:
+    /// Appends the original edges behind hierarchy edge `id` to `path`.
+    void unpack(Ix id, ShortestPath<Ix, W>& path) const
+    {
+        auto const m = edge_heads.size();
+        std::vector<Ix> stack(1, id);
+        while (!stack.empty()) {
+            auto const top = stack.back();
+            stack.pop_back();
+            if (top < m) {
+                path.edges.push_back(EdgeIndex<Ix>(top));
+                path.nodes.push_back(edge_heads[top]);
+            }
+            else {
+                auto const& shortcut = shortcuts[top - m];
+                stack.push_back(shortcut.second);
+                stack.push_back(shortcut.first);
+            }
+        }
+    }
+};
+
+namespace detail {
+
+/// Mutable adjacency the contraction works on: for every node not yet
+/// contracted, its cheapest arc to and from each remaining neighbor.
+template <typename Ix, typename W>
+struct ContractionGraph
+{
+    struct Arc
+    {
+        Ix node;
+        Ix id;
+        W weight;
+    };
+
+    struct Shortcut
+    {
+        Ix from;
+        Ix to;
+        W weight;
+        Ix first;
+        Ix second;
+    };
+
+    /// Adds or cheapens the arc `from -> to`; returns false if an arc at
+    /// least as cheap already exists.
+    bool relax(Ix from, Ix to, W weight, Ix id)
+    {
+        for (auto& arc : out[from]) {
+            if (arc.node == to) {
+                if (!(weight < arc.weight)) {
+                    return false;
+                }
+                arc.weight = weight;
+                arc.id = id;
+                for (auto& back : in[to]) {
+                    if (back.node == from) {
+                        back.weight = weight;
+                        back.id = id;
+                    }
+                }
+                return true;
+            }
+        }
+        out[from].push_back(Arc{to, id, weight});
+        in[to].push_back(Arc{from, id, weight});
+        return true;
+    }
+
+    static void erase(std::vector<Arc>& arcs, Ix node)
+    {
+        for (std::size_t i = 0; i < arcs.size();) {
+            if (arcs[i].node == node) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    /// Shortcuts needed to contract `v` while nodes with `excluded` set are
+    /// off limits. For every predecessor a local Dijkstra looks for a witness
+    /// path to each successor that is no longer than the path through `v`.
+    void shortcuts_for(Ix v, std::vector<std::uint8_t> const& excluded, std::size_t settle_limit,
+                       SearchWorkspace<Ix, W>& ws, std::vector<Shortcut>& found) const
+    {
+        using Mark = typename SearchWorkspace<Ix, W>::Mark;
+
+        found.clear();
+        if (out[v].empty()) {
+            return;
+        }
+        W longest_out = W();
+        for (auto const& arc : out[v]) {
+            longest_out = std::max(longest_out, arc.weight);
+        }
+
+        for (auto const& entry : in[v]) {
+            auto const a = entry.node;
+            auto const limit = entry.weight + longest_out;
+
+            // Successors are marked Seen up front, so the search can stop as
+            // soon as all of them are settled.
+            ws.begin(out.size());
+            std::size_t pending = 0;
+            for (auto const& exit : out[v]) {
+                if (exit.node != a && ws.mark_of(NodeIndex<Ix>(exit.node)) == Mark::Unseen) {
+                    ws.set_mark(NodeIndex<Ix>(exit.node), Mark::Seen);
+                    ++pending;
+                }
+            }
+            ws.touch(NodeIndex<Ix>(a));
+            ws.distance[a] = W();
+            ws.queue.push_or_decrease(a, W());
+            std::size_t settled = 0;
+            while (pending > 0 && !ws.queue.empty() && settled < settle_limit) {
+                auto const current = ws.queue.pop();
+                if (limit < current.priority) {
+                    break;
+                }
+                pending -= ws.mark[current.key] == Mark::Seen;
+                ws.mark[current.key] = Mark::Done;
+                ++settled;
+                for (auto const& arc : out[current.key]) {
+                    if (arc.node == v || excluded[arc.node]) {
+                        continue;
+                    }
+                    auto const candidate = current.priority + arc.weight;
+                    ws.touch(NodeIndex<Ix>(arc.node));
+                    if (candidate < ws.distance[arc.node]) {
+                        ws.distance[arc.node] = candidate;
+                        ws.queue.push_or_decrease(arc.node, candidate);
+                    }
+                }
+            }
+
+            for (auto const& exit : out[v]) {
+                if (exit.node == a) {
+                    continue;
+                }
+                auto const through = entry.weight + exit.weight;
+                if (through < ws.distance_to(NodeIndex<Ix>(exit.node))) {
+                    found.push_back(Shortcut{a, exit.node, through, entry.id, exit.id});
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<Arc>> out;
+    std::vector<std::vector<Arc>> in;
+};
+
+/// Compares contraction priorities, breaking ties by node id so every node
+/// has a strict order relative to its neighbors.
+template <typename Ix>
+bool contracts_before(std::vector<long> const& priority, Ix a, Ix b)
+{
+    return priority[a] < priority[b] || (priority[a] == priority[b] && a < b);
+}
+
+}
+
+/// Preprocesses `graph` into a contraction hierarchy under the costs of
+/// `weight_fn`, which must be non-negative. Shortcut costs and distances are
+/// summed in cost_distance_t of the cost type, as in dijkstra().
+///
+/// Nodes are ordered by edge difference: twice the shortcuts contracting a
+/// node would add minus the arcs it would remove, plus the number of
+/// neighbors already contracted to spread contraction evenly. Contraction proceeds in
+/// rounds. Each round takes every node whose priority is lower than that of
+/// all its remaining neighbors. Those nodes are pairwise non-adjacent, so
+/// their witness searches run in parallel with the whole round excluded, and
+/// their shortcuts are applied afterwards. Priorities are updated lazily:
+/// only neighbors of contracted nodes are re-simulated for the next round.
+template <typename N, typename E, typename Ix, typename Storage, typename Alloc, typename F>
+ContractionHierarchy<Ix, cost_distance_t<edge_cost_t<Graph<N, E, true, Ix, Storage, Alloc>, F>>>
+contract(Graph<N, E, true, Ix, Storage, Alloc> const& graph, F&& weight_fn, ContractionOptions const& options = ContractionOptions())
+{
+    using W = cost_distance_t<edge_cost_t<Graph<N, E, true, Ix, Storage, Alloc>, F>>;
+    using Work = detail::ContractionGraph<Ix, W>;
+
+    auto const n = graph.node_count();
+    auto const m = graph.edge_count();
+
+    ContractionHierarchy<Ix, W> ch;
+    ch.edge_heads.reserve(m);
+    Work work;
+    work.out.resize(n);
+    work.in.resize(n);
+    for (std::size_t e = 0; e < m; ++e) {
+        auto const ends = graph.edge_endpoints(EdgeIndex<Ix>(static_cast<Ix>(e)));
+        ch.edge_heads.push_back(ends.second);
+    }
+    for (std::size_t u = 0; u < n; ++u) {
+        for (auto const& edge : graph.edges_of(NodeIndex<Ix>(static_cast<Ix>(u)))) {
+            auto const cost = weight_fn(edge);
+            assert(!(cost < decltype(cost)()) && "contract requires non-negative edge costs");
+            if (edge.target() != edge.source()) {
+                work.relax(static_cast<Ix>(u), static_cast<Ix>(edge.target().index()), static_cast<W>(cost), static_cast<Ix>(edge.id().index()));
+            }
+        }
+    }
+
+    ThreadPool inline_pool(1);
+    auto& pool = options.pool ? *options.pool : inline_pool;
+    std::vector<SearchWorkspace<Ix, W>> workspaces(pool.size());
+    std::vector<std::vector<typename Work::Shortcut>> scratch(pool.size());
+
+    std::vector<long> priority(n, 0);
+    std::vector<long> contracted_neighbors(n, 0);
+    std::vector<std::uint8_t> excluded(n, 0);
+    std::vector<std::uint8_t> dirty(n, 1);
+    std::vector<Ix> remaining(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        remaining[v] = static_cast<Ix>(v);
+    }
+
+    auto simulate = [&](std::vector<Ix> const& nodes) {
+        pool.parallel_for(0, nodes.size(), 64, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                auto const v = nodes[i];
+                work.shortcuts_for(v, excluded, options.simulation_settle_limit, workspaces[id], scratch[id]);
+                priority[v] = 2 * static_cast<long>(scratch[id].size()) - static_cast<long>(work.in[v].size() + work.out[v].size())
+                    + contracted_neighbors[v];
+            }
+        });
+    };
+
+    std::vector<Ix> round;
+    std::vector<Ix> stale;
+    std::vector<std::vector<typename Work::Shortcut>> round_shortcuts;
+    std::vector<std::uint8_t> in_round(n, 0);
+
+    ch.rank.assign(n, 0);
+    ch.node_of_rank.reserve(n);
+    std::vector<std::vector<ChArc<Ix, W>>> up(n);
+    std::vector<std::vector<ChArc<Ix, W>>> down(n);
+
+    simulate(remaining);
+    std::fill(dirty.begin(), dirty.end(), 0);
+
+    while (!remaining.empty()) {
+        round.clear();
+        for (auto const v : remaining) {
+            bool minimal = true;
+            for (auto const* arcs : {&work.out[v], &work.in[v]}) {
+                for (auto const& arc : *arcs) {
+                    if (!detail::contracts_before(priority, v, arc.node)) {
+                        minimal = false;
+                        break;
+                    }
+                }
+                if (!minimal) {
+                    break;
+                }
+            }
+            if (minimal) {
+                round.push_back(v);
+            }
+        }
+        std::sort(round.begin(), round.end(), [&](Ix a, Ix b) { return detail::contracts_before(priority, a, b); });
+
+        // Witness searches for the whole round, each with every round member
+        // off limits, so shortcuts stay valid once all of them are gone.
+        for (auto const v : round) {
+            excluded[v] = 1;
+            in_round[v] = 1;
+        }
+        round_shortcuts.resize(round.size());
+        pool.parallel_for(0, round.size(), 16, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                work.shortcuts_for(round[i], excluded, options.witness_settle_limit, workspaces[id], round_shortcuts[i]);
+            }
+        });
+        for (auto const v : round) {
+            excluded[v] = 0;
+        }
+
+        for (std::size_t i = 0; i < round.size(); ++i) {
+            auto const v = round[i];
+            ch.rank[v] = static_cast<Ix>(ch.node_of_rank.size());
+            ch.node_of_rank.push_back(NodeIndex<Ix>(v));
+            for (auto const& arc : work.out[v]) {
+                up[v].push_back(ChArc<Ix, W>{arc.node, arc.id, arc.weight});
+                Work::erase(work.in[arc.node], v);
+                ++contracted_neighbors[arc.node];
+                dirty[arc.node] = 1;
+            }
+            for (auto const& arc : work.in[v]) {
+                down[v].push_back(ChArc<Ix, W>{arc.node, arc.id, arc.weight});
+                Work::erase(work.out[arc.node], v);
+                ++contracted_neighbors[arc.node];
+                dirty[arc.node] = 1;
+            }
+            work.out[v].clear();
+            work.in[v].clear();
+            work.out[v].shrink_to_fit();
+            work.in[v].shrink_to_fit();
+            for (auto const& s : round_shortcuts[i]) {
+                auto const id = m + ch.shortcuts.size();
+                assert(id < std::numeric_limits<Ix>::max() && "edge index space exhausted by shortcuts");
+                if (work.relax(s.from, s.to, s.weight, static_cast<Ix>(id))) {
+                    ch.shortcuts.push_back(ChShortcut<Ix>{s.first, s.second});
+                }
+            }
+        }
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](Ix v) { return in_round[v] != 0; }), remaining.end());
+        stale.clear();
+        for (auto const v : remaining) {
+            if (dirty[v]) {
+                stale.push_back(v);
+                dirty[v] = 0;
+            }
+        }
+        simulate(stale);
+    }
+
+    // Freeze both directions into rank-ordered CSR arrays, with heads
+    // translated to ranks. Arcs are value-initialised first so padding bytes
+    // are zero and the layout serializes deterministically.
+    auto freeze_arcs = [&](std::vector<std::vector<ChArc<Ix, W>>> const& lists, std::vector<std::size_t>& offsets,
+                           std::vector<ChArc<Ix, W>>& arcs) {
+        offsets.assign(n + 1, 0);
+        for (std::size_t r = 0; r < n; ++r) {
+            offsets[r + 1] = offsets[r] + lists[ch.node_of_rank[r].index()].size();
+        }
+        arcs.resize(offsets[n]);
+        for (std::size_t r = 0; r < n; ++r) {
+            auto slot = offsets[r];
+            for (auto const& arc : lists[ch.node_of_rank[r].index()]) {
+                arcs[slot].head = ch.rank[arc.head];
+                arcs[slot].id = arc.id;
+                arcs[slot].weight = arc.weight;
+                ++slot;
+            }
+        }
+    };
+    freeze_arcs(up, ch.up_offsets, ch.up_arcs);
+    freeze_arcs(down, ch.down_offsets, ch.down_arcs);
+    return ch;
+}
+
+/// Header of a file written by save_hierarchy(). The arrays of the
+/// hierarchy follow in declaration order, each stored verbatim.
+struct ContractionHierarchyHeader
+{
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint8_t index_width;
+    std::uint8_t weight_size;
+    std::uint8_t weight_is_float;
+    std::uint8_t reserved;
+    std::uint32_t padding;
+    std::uint64_t node_count;
+    std::uint64_t original_edge_count;
+    std::uint64_t shortcut_count;
+    std::uint64_t up_arc_count;
+    std::uint64_t down_arc_count;
+    std::uint64_t payload_checksum;
+    std::uint64_t header_checksum;
+};
+
+namespace detail {
+
+inline char const* hierarchy_magic()
+{
+    return "MGLCHIER";
+}
+
+/// Visits the arrays of `ch` in file order as (data, bytes) pairs.
+template <typename CH, typename F>
+void for_each_hierarchy_array(CH& ch, F&& fn)
+{
+    fn(ch.rank.data(), ch.rank.size() * sizeof(ch.rank[0]));
+    fn(ch.node_of_rank.data(), ch.node_of_rank.size() * sizeof(ch.node_of_rank[0]));
+    fn(ch.up_offsets.data(), ch.up_offsets.size() * sizeof(ch.up_offsets[0]));
+    fn(ch.up_arcs.data(), ch.up_arcs.size() * sizeof(ch.up_arcs[0]));
+    fn(ch.down_offsets.data(), ch.down_offsets.size() * sizeof(ch.down_offsets[0]));
+    fn(ch.down_arcs.data(), ch.down_arcs.size() * sizeof(ch.down_arcs[0]));
+    fn(ch.shortcuts.data(), ch.shortcuts.size() * sizeof(ch.shortcuts[0]));
+    fn(ch.edge_heads.data(), ch.edge_heads.size() * sizeof(ch.edge_heads[0]));
+}
+
+template <typename Ix, typename W>
+ContractionHierarchyHeader hierarchy_header_for(ContractionHierarchy<Ix, W> const& ch)
+{
+    ContractionHierarchyHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, hierarchy_magic(), sizeof(header.magic));
+    header.version = ContractionHierarchyHeader::current_version;
+    header.byte_order = BinaryGraphHeader::byte_order_mark;
+    header.index_width = sizeof(Ix);
+    header.weight_size = sizeof(W);
+    header.weight_is_float = std::is_floating_point<W>::value;
+    header.node_count = ch.rank.size();
+    header.original_edge_count = ch.edge_heads.size();
+    header.shortcut_count = ch.shortcuts.size();
+    header.up_arc_count = ch.up_arcs.size();
+    header.down_arc_count = ch.down_arcs.size();
+    return header;
+}
+
+}
+
+/// Writes `ch` to `path` so a restart can skip preprocessing. Files are in
+/// native byte order. Throws std::runtime_error on I/O failure.
+template <typename Ix, typename W>
+void save_hierarchy(ContractionHierarchy<Ix, W> const& ch, std::string const& path)
+{
+    static_assert(std::is_trivially_copyable<W>::value, "weights must be trivially copyable");
+
+    auto header = detail::hierarchy_header_for(ch);
+    std::uint64_t hash = 0;
+    detail::for_each_hierarchy_array(ch, [&](void const* data, std::size_t bytes) { hash = detail::checksum(data, bytes, hash); });
+    header.payload_checksum = hash;
+    header.header_checksum = detail::checksum(&header, offsetof(ContractionHierarchyHeader, header_checksum));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("cannot open " + path + " for writing");
+    }
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    detail::for_each_hierarchy_array(ch, [&](void const* data, std::size_t bytes) { out.write(static_cast<char const*>(data), bytes); });
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("failed writing " + path);
+    }
+}
+
+/// Reads a hierarchy written by save_hierarchy(). Throws std::runtime_error
+/// if the file is missing, truncated, corrupt, or was written for another
+/// index or weight type.
+template <typename Ix, typename W>
+ContractionHierarchy<Ix, W> load_hierarchy(std::string const& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    ContractionHierarchyHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, detail::hierarchy_magic(), sizeof(header.magic)) != 0) {
+        throw std::runtime_error(path + " is not a contraction hierarchy file");
+    }
+    if (header.byte_order != BinaryGraphHeader::byte_order_mark) {
+        throw std::runtime_error(path + " was written with a different byte order");
+    }
+    if (header.header_checksum != detail::checksum(&header, offsetof(ContractionHierarchyHeader, header_checksum))) {
+        throw std::runtime_error(path + " has a corrupt header");
+    }
+    if (header.version != ContractionHierarchyHeader::current_version) {
+        throw std::runtime_error(path + " has unsupported version " + std::to_string(header.version));
+    }
+    if (header.index_width != sizeof(Ix) || header.weight_size != sizeof(W)
+        || header.weight_is_float != std::is_floating_point<W>::value) {
+        throw std::runtime_error(path + " was written for a different index or weight type");
+    }
+
+    ContractionHierarchy<Ix, W> ch;
+    auto const n = static_cast<std::size_t>(header.node_count);
+    ch.rank.resize(n);
+    ch.node_of_rank.resize(n);
+    ch.up_offsets.resize(n + 1);
+    ch.up_arcs.resize(header.up_arc_count);
+    ch.down_offsets.resize(n + 1);
+    ch.down_arcs.resize(header.down_arc_count);
+    ch.shortcuts.resize(header.shortcut_count);
+    ch.edge_heads.resize(header.original_edge_count);
+
+    std::uint64_t hash = 0;
+    detail::for_each_hierarchy_array(ch, [&](void* data, std::size_t bytes) {
+        if (!in.read(static_cast<char*>(data), bytes)) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        hash = detail::checksum(data, bytes, hash);
+    });
+    if (hash != header.payload_checksum) {
+        throw std::runtime_error(path + " failed its payload checksum");
+    }
+    return ch;
+}
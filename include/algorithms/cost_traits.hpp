@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/// How shortest_paths() searches for a given edge cost type.
+enum class CostKind {
+    /// Every edge costs one hop: breadth-first search.
+    Unit,
+    /// Integers of at most 8 bits: Dial's bucket queue.
+    SmallInteger,
+    /// Wider integers: a radix heap.
+    Integer,
+    /// Anything else, floating point in particular: the indexed heap.
+    General
+};
+
+/// Compile-time description of edge cost type `W`: the search used for it
+/// and the type distances are summed in. Empty types, such as the NoWeight
+/// of `E = void` graphs, mean unit costs. Specialize it to route a custom
+/// cost type to one of the kernels.
+template <typename W, typename Enable = void>
+struct cost_traits
+{
+    static constexpr CostKind kind = std::is_empty<W>::value ? CostKind::Unit
+        : !std::is_integral<W>::value                          ? CostKind::General
+        : std::numeric_limits<W>::digits <= 8                  ? CostKind::SmallInteger
+                                                               : CostKind::Integer;
+
+    /// Hop counts for unit costs. Integer costs of any width are summed in
+    /// 64 bits of the same signedness, so a path longer than the largest
+    /// single cost cannot overflow. Other types are summed in themselves.
+    using distance_t = typename std::conditional<
+        kind == CostKind::Unit, std::size_t,
+        typename std::conditional<std::is_integral<W>::value,
+                                  typename std::conditional<std::is_signed<W>::value, std::int64_t, std::uint64_t>::type,
+                                  W>::type>::type;
+};
+
+template <typename W>
+using cost_distance_t = typename cost_traits<W>::distance_t;
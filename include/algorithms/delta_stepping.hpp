@@ -0,0 +1,219 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "parallel/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/// Parallel single-source shortest paths from `start` by delta-stepping,
+/// run on `pool`.
+///
+/// Tentative distances live in one flat array of atomics and only ever
+/// decrease, through a compare-and-swap minimum, so any thread may relax any
+/// edge. Nodes are kept in buckets of width `delta` by tentative distance,
+/// one set of buckets per thread. The smallest non-empty bucket is emptied in
+/// parallel rounds that relax only light edges (cost at most `delta`), which
+/// may refill the same bucket. The heavy edges met on the way are not walked
+/// again: their relaxation requests are buffered and applied in one more
+/// round once the bucket stays empty, and can only reach later buckets.
+/// Stale bucket entries, left behind when a node's distance dropped again,
+/// are skipped. Queued distances never run far past the bucket being
+/// emptied, so each thread's buckets form a ring reused cyclically: three
+/// slots cover the light edges, and the ring grows between rounds only when
+/// a buffered heavy request would land beyond it.
+///
+/// The distances equal dijkstra()'s exactly, floating-point rounding
+/// included, since both are the least solution of the same relaxation
+/// equations. Which of several equally short paths ends up in the tree is
+/// unspecified. The tree is rebuilt at the end: a node's parent is an
+/// in-neighbour on a shortest path that is strictly closer, or as close but
+/// finalised in an earlier round, so it is acyclic even across zero-cost
+/// edges.
+/// `delta` trades work for parallelism: around the average edge cost is a
+/// good start. Very small values create long runs of empty buckets and
+/// rings of up to `max_cost / delta` slots.
+/// `weight_fn` must return non-negative costs and be safe to call from
+/// several threads. Ingoing edges are used to rebuild the tree.
+template <typename G, typename F, typename W>
+DijkstraResult<typename G::index_t, W> delta_stepping(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+                                                      W delta, ThreadPool& pool, std::size_t grain = 64)
+{
+    using Ix = typename G::index_t;
+    using round_t = std::uint32_t;
+
+    assert(W() < delta && "delta_stepping requires a positive bucket width");
+
+    auto const n = graph.node_count();
+    auto const infinity = DijkstraResult<Ix, W>::infinity();
+    auto const bucket_of = [delta](W d) { return static_cast<std::size_t>(d / delta); };
+
+    std::vector<std::atomic<W>> distance(n);
+    std::vector<std::atomic<round_t>> improved_in(n);
+    std::vector<std::atomic<round_t>> processed_in(n);
+    pool.parallel_for(0, n, 4096, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i) {
+            distance[i].store(infinity, std::memory_order_relaxed);
+            improved_in[i].store(0, std::memory_order_relaxed);
+            processed_in[i].store(0, std::memory_order_relaxed);
+        }
+    });
+
+    // A light edge from bucket b reaches at most bucket b + 1; the third
+    // slot absorbs rounding in bucket_of.
+    std::size_t span = 3;
+    std::vector<std::vector<std::vector<NodeIndex<Ix>>>> buckets(pool.size(), std::vector<std::vector<NodeIndex<Ix>>>(span));
+    std::vector<std::vector<std::pair<NodeIndex<Ix>, W>>> heavy(pool.size());
+    std::vector<std::pair<NodeIndex<Ix>, W>> requests;
+    std::vector<NodeIndex<Ix>> frontier;
+    round_t round = 0;
+
+    auto relax = [&](NodeIndex<Ix> v, W candidate, std::size_t id) {
+        auto& slot = distance[v.index()];
+        auto current = slot.load(std::memory_order_relaxed);
+        while (candidate < current) {
+            improved_in[v.index()].store(round, std::memory_order_relaxed);
+            if (slot.compare_exchange_weak(current, candidate, std::memory_order_release, std::memory_order_relaxed)) {
+                buckets[id][bucket_of(candidate) % span].push_back(v);
+                return;
+            }
+        }
+    };
+
+    /// Relaxes the light edges of every node in `frontier` and buffers
+    /// requests for its heavy ones. Skips stale entries, duplicates and nodes
+    /// improved during the same round, which are queued again anyway; so
+    /// every relaxation starts from a distance fixed in an earlier round.
+    auto light_round = [&](std::size_t bucket) {
+        ++round;
+        pool.parallel_for(0, frontier.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                auto const u = frontier[i];
+                auto const reached = distance[u.index()].load(std::memory_order_acquire);
+                if (bucket_of(reached) != bucket || improved_in[u.index()].load(std::memory_order_relaxed) == round
+                    || processed_in[u.index()].exchange(round, std::memory_order_relaxed) == round) {
+                    continue;
+                }
+                for (auto const& edge : graph.edges_of(u)) {
+                    auto const cost = weight_fn(edge);
+                    assert(!(cost < W()) && "delta_stepping requires non-negative edge costs");
+                    if (delta < cost) {
+                        heavy[id].emplace_back(edge.target(), reached + cost);
+                    }
+                    else {
+                        relax(edge.target(), reached + cost, id);
+                    }
+                }
+            }
+        });
+    };
+
+    /// Widens every ring to at least `needed` slots once `bucket` has been
+    /// emptied. Entries are placed again by their node's current distance;
+    /// those already settled are stale and dropped.
+    auto grow = [&](std::size_t needed, std::size_t bucket) {
+        span = std::max(needed, 2 * span);
+        for (auto& mine : buckets) {
+            std::vector<std::vector<NodeIndex<Ix>>> ring(span);
+            for (auto const& slot : mine) {
+                for (auto const v : slot) {
+                    auto const k = bucket_of(distance[v.index()].load(std::memory_order_relaxed));
+                    if (k > bucket) {
+                        ring[k % span].push_back(v);
+                    }
+                }
+            }
+            mine = std::move(ring);
+        }
+    };
+
+    /// Applies the buffered heavy requests of the bucket just emptied,
+    /// growing the rings first if one of them lands beyond their reach.
+    auto heavy_round = [&](std::size_t bucket) {
+        ++round;
+        requests.clear();
+        for (auto& mine : heavy) {
+            requests.insert(requests.end(), mine.begin(), mine.end());
+            mine.clear();
+        }
+        std::size_t farthest = bucket;
+        for (auto const& request : requests) {
+            farthest = std::max(farthest, bucket_of(request.second));
+        }
+        if (farthest - bucket + 2 > span) {
+            grow(farthest - bucket + 2, bucket);
+        }
+        pool.parallel_for(0, requests.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                relax(requests[i].first, requests[i].second, id);
+            }
+        });
+    };
+
+    distance[start.index()].store(W(), std::memory_order_relaxed);
+    buckets[0][0].push_back(start);
+
+    for (std::size_t bucket = 0;; ++bucket) {
+        auto const next = [&] {
+            for (auto k = bucket; k < bucket + span; ++k) {
+                for (auto const& mine : buckets) {
+                    if (!mine[k % span].empty()) {
+                        return k;
+                    }
+                }
+            }
+            return std::numeric_limits<std::size_t>::max();
+        }();
+        if (next == std::numeric_limits<std::size_t>::max()) {
+            break;
+        }
+        bucket = next;
+
+        while (true) {
+            frontier.clear();
+            for (auto& mine : buckets) {
+                auto& slot = mine[bucket % span];
+                frontier.insert(frontier.end(), slot.begin(), slot.end());
+                slot.clear();
+            }
+            if (frontier.empty()) {
+                break;
+            }
+            light_round(bucket);
+        }
+        heavy_round(bucket);
+    }
+
+    DijkstraResult<Ix, W> result;
+    result.reset(n, start);
+    pool.parallel_for(0, n, 1024, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (auto i = first; i < last; ++i) {
+            auto const v = NodeIndex<Ix>(static_cast<Ix>(i));
+            auto const d = distance[i].load(std::memory_order_relaxed);
+            result.distance[i] = d;
+            if (d == infinity || v == start) {
+                continue;
+            }
+            auto const when = improved_in[i].load(std::memory_order_relaxed);
+            for (auto const& edge : graph.edges_directed(v, Direction::Direction::Ingoing)) {
+                auto const u = edge.source();
+                auto const du = distance[u.index()].load(std::memory_order_relaxed);
+                if (du == infinity || !(du + weight_fn(edge) == d)) {
+                    continue;
+                }
+                if (du < d || improved_in[u.index()].load(std::memory_order_relaxed) < when) {
+                    result.parent[i] = u;
+                    result.parent_edge[i] = edge.id();
+                    break;
+                }
+            }
+        }
+    });
+    return result;
+}
@@ -1,43 +1,195 @@
 #pragma once
 
 #include "graph.hpp"
+#include "algorithms/cost_traits.hpp"
+#include "algorithms/search_stats.hpp"
+#include "algorithms/search_workspace.hpp"
 
-#include <map>
-#include <set>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
-/// F must return something convertible to double
-template <typename T, bool is_directed, typename F>
-std::pair<std::map<typename Graph<T, is_directed>::iterator, double>, std::map<typename Graph<T, is_directed>::iterator, typename Graph<T, is_directed>::iterator>>
-dijkstra(Graph<T, is_directed>& g, Graph<T, is_directed>::iterator source, F&& weight)
+/// The type `weight_fn` returns for an edge of `G`. Searches that pick their
+/// own distance type sum it in cost_distance_t of this type.
+template <typename G, typename F>
+using edge_cost_t = typename std::decay<decltype(std::declval<F&>()(std::declval<typename G::edge_reference_t const&>()))>::type;
+
+/// Distances and shortest-path tree of a single-source search, stored in flat
+/// vectors indexed by NodeIndex::index(). A result can be passed back into
+/// dijkstra() to reuse its storage for the next query. Callers that only need
+/// a few entries of the answer should search into a SearchWorkspace instead,
+/// which avoids the O(n) copy-out. All storage, the embedded workspace's
+/// included, is allocated through `Alloc`.
+template <typename Ix, typename W, typename Alloc = std::allocator<char>>
+struct DijkstraResult
 {
-    using weight_t = double;
-    using graph_t = Graph<T, is_directed>;
-    using iterator_t = typename graph_t::iterator;
-    using value = std::pair<iterator_t, weight_t>;
-
-    auto compare = [](value const& lhs, value const& rhs){
-        return lhs.second < rhs.second;
-    };
-
-    std::multiset<value, compare> q;
-
-    std::map<iterator_t, weight_t> distance{{source, 0}};
-    std::map<iterator_t, iterator_t> parent{{source, g.end()}};
-
-    q.push(std::make_pair(source, 0));
-    while (!q.empty()) {
-        auto current = q.front();
-        q.pop();
-        for (auto&& it : g.adjacent_vertices_of(current.first)) {
-            weight_t new_cost = current.second + F(current, it);
-            if (new_cost < distance[it]) {
-                distance[it] = new_cost;
-                parent[it] = current;
-                q.push(it);
+    using allocator_type = Alloc;
+
+    DijkstraResult() = default;
+
+    explicit DijkstraResult(Alloc const& alloc)
+    : distance(alloc)
+    , parent(alloc)
+    , parent_edge(alloc)
+    , workspace(alloc)
+    {
+    }
+
+    static W infinity()
+    {
+        return std::numeric_limits<W>::max();
+    }
+
+    void reset(std::size_t node_count, NodeIndex<Ix> start)
+    {
+        source = start;
+        distance.assign(node_count, infinity());
+        parent.assign(node_count, NodeIndex<Ix>::end());
+        parent_edge.assign(node_count, EdgeIndex<Ix>::end());
+    }
+
+    bool reachable(NodeIndex<Ix> v) const
+    {
+        return distance[v.index()] != infinity();
+    }
+
+    W distance_to(NodeIndex<Ix> v) const
+    {
+        return distance[v.index()];
+    }
+
+    /// Nodes on the shortest path from the source to `v`, inclusive. Empty if
+    /// `v` was not reached.
+    std::vector<NodeIndex<Ix>> path_to(NodeIndex<Ix> v) const
+    {
+        std::vector<NodeIndex<Ix>> path;
+        if (!reachable(v)) {
+            return path;
+        }
+        for (auto u = v; u != NodeIndex<Ix>::end(); u = parent[u.index()]) {
+            path.push_back(u);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    /// Copies the answer of the last query out of `ws`.
+    void assign(SearchWorkspace<Ix, W, Alloc> const& ws, std::size_t node_count)
+    {
+        reset(node_count, ws.source);
+        for (std::size_t i = 0; i < node_count; ++i) {
+            auto const v = NodeIndex<Ix>(static_cast<Ix>(i));
+            if (ws.touched(v)) {
+                distance[i] = ws.distance[i];
+                parent[i] = ws.parent[i];
+                parent_edge[i] = ws.parent_edge[i];
             }
         }
     }
 
-    return std::make_pair(distance, parent);
+    NodeIndex<Ix> source;
+    std::vector<W, rebind_alloc_t<Alloc, W>> distance;
+    std::vector<NodeIndex<Ix>, rebind_alloc_t<Alloc, NodeIndex<Ix>>> parent;
+    std::vector<EdgeIndex<Ix>, rebind_alloc_t<Alloc, EdgeIndex<Ix>>> parent_edge;
+    SearchWorkspace<Ix, W, Alloc> workspace;
+};
+
+/// Single-source shortest paths from `start`, written into `ws` and valid
+/// until its next query. `weight_fn` is called with the graph's edge reference
+/// and must return a non-negative cost. If `target` is given the search stops
+/// as soon as it is settled; nodes that were still queued at that point only
+/// have upper-bound distances. Does not allocate once `ws` has grown to the
+/// size of the graph. The work done is reported to `stats`, a stats policy
+/// such as SearchStats.
+template <typename G, typename F, typename W, typename A, typename S>
+void dijkstra(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+              SearchWorkspace<typename G::index_t, W, A>& ws, NodeIndex<typename G::index_t> target, S& stats)
+{
+    using Ix = typename G::index_t;
+    using Mark = typename SearchWorkspace<Ix, W, A>::Mark;
+
+    stats.begin(SearchKind::Dijkstra);
+    ws.begin(graph.node_count());
+    ws.source = start;
+    ws.touch(start);
+    ws.distance[start.index()] = W();
+    ws.queue.push_or_decrease(static_cast<Ix>(start.index()), W());
+    stats.discover();
+    stats.push();
+    stats.frontier(1);
+
+    while (!ws.queue.empty()) {
+        auto const current = ws.queue.pop();
+        auto const u = NodeIndex<Ix>(current.key);
+        ws.mark[u.index()] = Mark::Done;
+        stats.settle();
+        if (u == target) {
+            break;
+        }
+        for (auto const& edge : graph.edges_of(u)) {
+            auto const cost = weight_fn(edge);
+            assert(!(cost < W()) && "dijkstra requires non-negative edge costs");
+            auto const v = edge.target();
+            auto const candidate = current.priority + static_cast<W>(cost);
+            stats.relax();
+            ws.touch(v);
+            if (candidate < ws.distance[v.index()]) {
+                if constexpr (S::enabled) {
+                    if (ws.queue.contains(static_cast<Ix>(v.index()))) {
+                        stats.decrease();
+                    }
+                    else {
+                        stats.discover();
+                        stats.push();
+                    }
+                }
+                ws.distance[v.index()] = candidate;
+                ws.parent[v.index()] = u;
+                ws.parent_edge[v.index()] = edge.id();
+                ws.queue.push_or_decrease(static_cast<Ix>(v.index()), candidate);
+                stats.frontier(ws.queue.size());
+            }
+        }
+    }
+    stats.end();
+}
+
+template <typename G, typename F, typename W, typename A>
+void dijkstra(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+              SearchWorkspace<typename G::index_t, W, A>& ws,
+              NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    NoStats stats;
+    dijkstra(graph, start, std::forward<F>(weight_fn), ws, target, stats);
+}
+
+/// Same search, with the answer copied into the dense vectors of `result`.
+template <typename G, typename F, typename W, typename A>
+void dijkstra(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+              DijkstraResult<typename G::index_t, W, A>& result,
+              NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    dijkstra(graph, start, std::forward<F>(weight_fn), result.workspace, target);
+    result.assign(result.workspace, graph.node_count());
+}
+
+template <typename G, typename F, typename W, typename A, typename S>
+void dijkstra(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+              DijkstraResult<typename G::index_t, W, A>& result, NodeIndex<typename G::index_t> target, S& stats)
+{
+    dijkstra(graph, start, std::forward<F>(weight_fn), result.workspace, target, stats);
+    result.assign(result.workspace, graph.node_count());
+}
+
+template <typename G, typename F>
+DijkstraResult<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>>
+dijkstra(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+         NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    DijkstraResult<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>> result;
+    dijkstra(graph, start, std::forward<F>(weight_fn), result, target);
+    return result;
 }
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/indexed_heap.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/// Single-source shortest paths from one source, kept up to date while the
+/// graph changes. Change edge weights through Graph::edge_weight() or add
+/// edges with Graph::add_edge(), then pass the indices of the touched edges
+/// to update(); the tree is repaired in place instead of being recomputed.
+///
+/// A weight decrease or a new edge only re-settles the nodes whose distance
+/// actually drops. An increase on a tree edge invalidates the subtree below
+/// it, reseeds that subtree from its unaffected in-neighbours and re-settles
+/// it; an increase on a non-tree edge costs nothing. A repair is thus
+/// proportional to the changed subtrees and their ingoing edges, not to the
+/// graph. Nodes added to the graph are picked up as unreachable until an
+/// update connects them. Removing edges is not tracked; recompute() instead.
+///
+/// `weight_fn` is called with `G::edge_reference_t` like dijkstra()'s and
+/// must keep returning non-negative costs.
+template <typename G, typename F>
+struct DynamicSssp
+{
+    using index_t = typename G::index_t;
+    using weight_t = edge_cost_t<G, F>;
+    using Ix = index_t;
+    /// Distance type, the same one dijkstra() sums `weight_t` in.
+    using W = cost_distance_t<weight_t>;
+
+    DynamicSssp(G const& graph, NodeIndex<Ix> source, F weight_fn)
+    : graph(&graph)
+    , weight_fn(std::move(weight_fn))
+    {
+        recompute(source);
+    }
+
+    /// Discards the tree and runs a full search from `source`.
+    void recompute(NodeIndex<Ix> source)
+    {
+        dijkstra(*graph, source, weight_fn, paths);
+        auto const n = graph->node_count();
+        first_child.assign(n, NodeIndex<Ix>::end());
+        next_sibling.assign(n, NodeIndex<Ix>::end());
+        prev_sibling.assign(n, NodeIndex<Ix>::end());
+        affected.assign(n, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (paths.parent[i] != NodeIndex<Ix>::end()) {
+                link_child(paths.parent[i], NodeIndex<Ix>(static_cast<Ix>(i)));
+            }
+        }
+    }
+
+    /// Repairs the tree after the weight of edge `e` changed or `e` was added.
+    std::size_t update(EdgeIndex<Ix> e)
+    {
+        return update(&e, &e + 1);
+    }
+
+    /// Repairs the tree after a batch of edges in `[first, last)` changed
+    /// weight or were added. A batch is cheaper than one update() per edge,
+    /// since overlapping subtrees are invalidated and re-settled once. Returns
+    /// the number of nodes settled during the repair.
+    template <typename It>
+    std::size_t update(It first, It last)
+    {
+        grow(graph->node_count());
+        pending.clear();
+        roots.clear();
+        for (auto it = first; it != last; ++it) {
+            auto const e = EdgeIndex<Ix>(*it);
+            for (auto const& arc : arcs_of(e)) {
+                auto const u = arc.source();
+                auto const v = arc.target();
+                if (paths.parent_edge[v.index()] == e && paths.parent[v.index()] == u
+                    && paths.distance[v.index()] < paths.distance[u.index()] + cost(arc)) {
+                    roots.push_back(v);
+                }
+                else {
+                    pending.push_back(arc);
+                }
+            }
+        }
+
+        invalidate_subtrees();
+        for (auto x : invalid) {
+            for (auto const& edge : graph->edges_directed(x, Direction::Direction::Ingoing)) {
+                if (!affected[edge.source().index()]) {
+                    relax(edge);
+                }
+            }
+        }
+        for (auto const& arc : pending) {
+            if (!affected[arc.source().index()]) {
+                relax(arc);
+            }
+        }
+        for (auto x : invalid) {
+            affected[x.index()] = 0;
+        }
+
+        std::size_t settled = 0;
+        while (!queue.empty()) {
+            auto const u = NodeIndex<Ix>(queue.pop().key);
+            ++settled;
+            for (auto const& edge : graph->edges_of(u)) {
+                relax(edge);
+            }
+        }
+        return settled;
+    }
+
+    NodeIndex<Ix> source() const
+    {
+        return paths.source;
+    }
+
+    bool reachable(NodeIndex<Ix> v) const
+    {
+        return v.index() < paths.distance.size() && paths.reachable(v);
+    }
+
+    W distance_to(NodeIndex<Ix> v) const
+    {
+        return v.index() < paths.distance.size() ? paths.distance_to(v) : DijkstraResult<Ix, W>::infinity();
+    }
+
+    NodeIndex<Ix> parent_of(NodeIndex<Ix> v) const
+    {
+        return v.index() < paths.parent.size() ? paths.parent[v.index()] : NodeIndex<Ix>::end();
+    }
+
+    EdgeIndex<Ix> parent_edge_of(NodeIndex<Ix> v) const
+    {
+        return v.index() < paths.parent_edge.size() ? paths.parent_edge[v.index()] : EdgeIndex<Ix>::end();
+    }
+
+    std::vector<NodeIndex<Ix>> path_to(NodeIndex<Ix> v) const
+    {
+        return v.index() < paths.distance.size() ? paths.path_to(v) : std::vector<NodeIndex<Ix>>();
+    }
+
+    /// Current distances and tree, in the same layout as a dijkstra() result.
+    DijkstraResult<Ix, W> const& result() const
+    {
+        return paths;
+    }
+
+private:
+    using arc_t = typename G::edge_reference_t;
+
+    W cost(arc_t const& arc)
+    {
+        auto const c = weight_fn(arc);
+        assert(!(c < W()) && "DynamicSssp requires non-negative edge costs");
+        return c;
+    }
+
+    /// The orientations in which `e` can be traversed: one for directed
+    /// graphs, both for undirected ones.
+    std::vector<arc_t> const& arcs_of(EdgeIndex<Ix> e)
+    {
+        auto const ends = graph->edge_endpoints(e);
+        auto const* weight = &graph->edge_weight(e);
+        arcs.clear();
+        arcs.push_back(arc_t{e, {{ends.first, ends.second}}, weight});
+        if (!graph->is_directed() && ends.first != ends.second) {
+            arcs.push_back(arc_t{e, {{ends.second, ends.first}}, weight});
+        }
+        return arcs;
+    }
+
+    void relax(arc_t const& arc)
+    {
+        auto const u = arc.source();
+        auto const v = arc.target();
+        if (!paths.reachable(u)) {
+            return;
+        }
+        auto const candidate = paths.distance[u.index()] + cost(arc);
+        if (candidate < paths.distance[v.index()]) {
+            paths.distance[v.index()] = candidate;
+            paths.parent_edge[v.index()] = arc.id();
+            if (paths.parent[v.index()] != u) {
+                unlink_child(v);
+                link_child(u, v);
+            }
+            queue.push_or_decrease(static_cast<Ix>(v.index()), candidate);
+        }
+    }
+
+    /// Detaches the subtree below every root and marks its nodes unreached.
+    void invalidate_subtrees()
+    {
+        invalid.clear();
+        for (auto root : roots) {
+            if (affected[root.index()]) {
+                continue;
+            }
+            auto const begin = invalid.size();
+            affected[root.index()] = 1;
+            invalid.push_back(root);
+            for (auto i = begin; i < invalid.size(); ++i) {
+                for (auto c = first_child[invalid[i].index()]; c != NodeIndex<Ix>::end(); c = next_sibling[c.index()]) {
+                    if (!affected[c.index()]) {
+                        affected[c.index()] = 1;
+                        invalid.push_back(c);
+                    }
+                }
+            }
+        }
+        for (auto x : invalid) {
+            unlink_child(x);
+            first_child[x.index()] = NodeIndex<Ix>::end();
+            paths.distance[x.index()] = DijkstraResult<Ix, W>::infinity();
+            paths.parent_edge[x.index()] = EdgeIndex<Ix>::end();
+        }
+    }
+
+    void link_child(NodeIndex<Ix> parent, NodeIndex<Ix> child)
+    {
+        auto const head = first_child[parent.index()];
+        paths.parent[child.index()] = parent;
+        prev_sibling[child.index()] = NodeIndex<Ix>::end();
+        next_sibling[child.index()] = head;
+        if (head != NodeIndex<Ix>::end()) {
+            prev_sibling[head.index()] = child;
+        }
+        first_child[parent.index()] = child;
+    }
+
+    void unlink_child(NodeIndex<Ix> child)
+    {
+        auto const parent = paths.parent[child.index()];
+        if (parent == NodeIndex<Ix>::end()) {
+            return;
+        }
+        auto const prev = prev_sibling[child.index()];
+        auto const next = next_sibling[child.index()];
+        if (prev != NodeIndex<Ix>::end()) {
+            next_sibling[prev.index()] = next;
+        }
+        else {
+            first_child[parent.index()] = next;
+        }
+        if (next != NodeIndex<Ix>::end()) {
+            prev_sibling[next.index()] = prev;
+        }
+        paths.parent[child.index()] = NodeIndex<Ix>::end();
+    }
+
+    /// Extends every per-node array to cover nodes added since the last
+    /// update, as unreached leaves.
+    void grow(std::size_t n)
+    {
+        if (paths.distance.size() < n) {
+            paths.distance.resize(n, DijkstraResult<Ix, W>::infinity());
+            paths.parent.resize(n, NodeIndex<Ix>::end());
+            paths.parent_edge.resize(n, EdgeIndex<Ix>::end());
+            first_child.resize(n, NodeIndex<Ix>::end());
+            next_sibling.resize(n, NodeIndex<Ix>::end());
+            prev_sibling.resize(n, NodeIndex<Ix>::end());
+            affected.resize(n, 0);
+        }
+        queue.clear(n);
+    }
+
+    G const* graph;
+    F weight_fn;
+    DijkstraResult<Ix, W> paths;
+    /// The shortest-path tree as intrusive child lists, so a subtree can be
+    /// walked and a node re-parented in O(1).
+    std::vector<NodeIndex<Ix>> first_child;
+    std::vector<NodeIndex<Ix>> next_sibling;
+    std::vector<NodeIndex<Ix>> prev_sibling;
+    std::vector<std::uint8_t> affected;
+    std::vector<NodeIndex<Ix>> roots;
+    std::vector<NodeIndex<Ix>> invalid;
+    std::vector<arc_t> pending;
+    std::vector<arc_t> arcs;
+    IndexedHeap<Ix, W> queue;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// Min-heap of keys in `[0, capacity)` ordered by a priority, with O(1)
+/// membership test and O(log n) decrease-key. Positions are tracked in a
+/// dense array indexed by key, so keys should be small dense integers such
+/// as NodeIndex::index(). Both arrays use `Alloc`, rebound.
+template <typename K, typename P, std::size_t Arity = 4, typename Alloc = std::allocator<char>>
+struct IndexedHeap
+{
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    struct Entry
+    {
+        P priority;
+        K key;
+    };
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    using entry_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+    using position_allocator_t = typename std::allocator_traits<Alloc>::template rebind_alloc<std::size_t>;
+
+    IndexedHeap() = default;
+
+    explicit IndexedHeap(Alloc const& alloc)
+    : heap(entry_allocator_t(alloc))
+    , position(position_allocator_t(alloc))
+    {
+    }
+
+    /// Empties the heap and makes room for keys in `[0, capacity)`.
+    void reset(std::size_t capacity)
+    {
+        heap.clear();
+        position.assign(capacity, npos);
+    }
+
+    /// Empties the heap in O(size) without touching positions of keys that
+    /// were never queued, and grows the key range to at least `capacity`.
+    void clear(std::size_t capacity)
+    {
+        for (auto const& entry : heap) {
+            position[entry.key] = npos;
+        }
+        heap.clear();
+        if (position.size() < capacity) {
+            position.resize(capacity, npos);
+        }
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    std::size_t size() const
+    {
+        return heap.size();
+    }
+
+    bool contains(K key) const
+    {
+        return position[key] != npos;
+    }
+
+    Entry const& top() const
+    {
+        return heap.front();
+    }
+
+    /// Inserts `key`, or lowers its priority if it is already queued with a
+    /// larger one. Returns false when the heap was left unchanged.
+    bool push_or_decrease(K key, P priority)
+    {
+        auto const pos = position[key];
+        if (pos == npos) {
+            heap.push_back(Entry{priority, key});
+            position[key] = heap.size() - 1;
+            sift_up(heap.size() - 1);
+            return true;
+        }
+        if (priority < heap[pos].priority) {
+            heap[pos].priority = priority;
+            sift_up(pos);
+            return true;
+        }
+        return false;
+    }
+
+    Entry pop()
+    {
+        auto const result = heap.front();
+        position[result.key] = npos;
+        auto const last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            position[last.key] = 0;
+            sift_down(0);
+        }
+        return result;
+    }
+
+    std::vector<Entry, entry_allocator_t> heap;
+    std::vector<std::size_t, position_allocator_t> position;
+
+private:
+    void sift_up(std::size_t i)
+    {
+        auto const entry = heap[i];
+        while (i > 0) {
+            auto const parent = (i - 1) / Arity;
+            if (!(entry.priority < heap[parent].priority)) {
+                break;
+            }
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    void sift_down(std::size_t i)
+    {
+        auto const entry = heap[i];
+        auto const n = heap.size();
+        while (true) {
+            auto const first = i * Arity + 1;
+            if (first >= n) {
+                break;
+            }
+            auto const last = first + Arity < n ? first + Arity : n;
+            auto best = first;
+            for (auto c = first + 1; c < last; ++c) {
+                if (heap[c].priority < heap[best].priority) {
+                    best = c;
+                }
+            }
+            if (!(heap[best].priority < entry.priority)) {
+                break;
+            }
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+    void place(std::size_t i, Entry const& entry)
+    {
+        heap[i] = entry;
+        position[entry.key] = i;
+    }
+};
+
+template <typename K, typename P, std::size_t Arity, typename Alloc>
+constexpr std::size_t IndexedHeap<K, P, Arity, Alloc>::npos;
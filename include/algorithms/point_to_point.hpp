@@ -0,0 +1,226 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/search_workspace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/// Answer of a source-to-target query: the distance, the nodes and edges of
+/// one shortest path, and how many nodes the search settled to find it.
+template <typename Ix, typename W>
+struct ShortestPath
+{
+    static W infinity()
+    {
+        return std::numeric_limits<W>::max();
+    }
+
+    bool found() const
+    {
+        return distance != infinity();
+    }
+
+    W distance = infinity();
+    /// Nodes from source to target, inclusive. Empty if there is no path.
+    std::vector<NodeIndex<Ix>> nodes;
+    /// Edges from source to target; one fewer than `nodes`.
+    std::vector<EdgeIndex<Ix>> edges;
+    std::size_t settled = 0;
+};
+
+/// Scratch state of bidirectional_dijkstra(): one search tree grown from the
+/// source over outgoing edges and one grown from the target over ingoing
+/// edges. Reusable across queries like SearchWorkspace, and allocates both
+/// trees through `Alloc`.
+template <typename Ix, typename W = double, typename Alloc = std::allocator<char>>
+struct BidirectionalWorkspace
+{
+    using allocator_type = Alloc;
+
+    BidirectionalWorkspace() = default;
+
+    explicit BidirectionalWorkspace(Alloc const& alloc)
+    : forward(alloc)
+    , backward(alloc)
+    {
+    }
+
+    SearchWorkspace<Ix, W, Alloc> forward;
+    SearchWorkspace<Ix, W, Alloc> backward;
+};
+
+namespace detail {
+
+/// Appends the tree path from `ws.source` to `v` to `path`, or the reverse of
+/// it when `toward_source` is set, leaving `v` itself out.
+template <typename Ix, typename W, typename A>
+void append_tree_path(SearchWorkspace<Ix, W, A> const& ws, NodeIndex<Ix> v, bool toward_source, ShortestPath<Ix, W>& path)
+{
+    auto const first_node = path.nodes.size();
+    auto const first_edge = path.edges.size();
+    for (auto u = v; ws.parent_of(u) != NodeIndex<Ix>::end(); u = ws.parent_of(u)) {
+        path.nodes.push_back(ws.parent_of(u));
+        path.edges.push_back(ws.parent_edge_of(u));
+    }
+    if (!toward_source) {
+        std::reverse(path.nodes.begin() + first_node, path.nodes.end());
+        std::reverse(path.edges.begin() + first_edge, path.edges.end());
+    }
+}
+
+}
+
+/// Shortest path from `source` to `target` by growing a forward search from
+/// the source and a backward search from the target, always advancing the
+/// side with the smaller queue. Every edge relaxed into a node the other side
+/// has reached yields a candidate path; the search stops once the two queue
+/// minima together are no smaller than the best candidate, which is then
+/// optimal. Undirected graphs need no special handling, since their ingoing
+/// edges are their outgoing ones. `weight_fn` must return non-negative
+/// costs. Does not allocate beyond the returned path once `ws` has grown to
+/// the size of the graph.
+template <typename G, typename F, typename W, typename A>
+ShortestPath<typename G::index_t, W>
+bidirectional_dijkstra(G const& graph, NodeIndex<typename G::index_t> source, NodeIndex<typename G::index_t> target,
+                       F&& weight_fn, BidirectionalWorkspace<typename G::index_t, W, A>& ws)
+{
+    using Ix = typename G::index_t;
+    using Mark = typename SearchWorkspace<Ix, W, A>::Mark;
+
+    ShortestPath<Ix, W> result;
+    auto const n = graph.node_count();
+    ws.forward.begin(n);
+    ws.backward.begin(n);
+    for (auto* side : {&ws.forward, &ws.backward}) {
+        auto const root = side == &ws.forward ? source : target;
+        side->source = root;
+        side->touch(root);
+        side->distance[root.index()] = W();
+        side->queue.push_or_decrease(static_cast<Ix>(root.index()), W());
+    }
+
+    auto meet = NodeIndex<Ix>::end();
+    if (source == target) {
+        result.distance = W();
+        meet = source;
+    }
+
+    while (!ws.forward.queue.empty() && !ws.backward.queue.empty()) {
+        if (!(ws.forward.queue.top().priority + ws.backward.queue.top().priority < result.distance)) {
+            break;
+        }
+        bool const forward = ws.forward.queue.size() <= ws.backward.queue.size();
+        auto& self = forward ? ws.forward : ws.backward;
+        auto& other = forward ? ws.backward : ws.forward;
+        auto const dir = forward ? Direction::Direction::Outgoing : Direction::Direction::Ingoing;
+
+        auto const current = self.queue.pop();
+        auto const u = NodeIndex<Ix>(current.key);
+        self.mark[u.index()] = Mark::Done;
+        ++result.settled;
+
+        for (auto const& edge : graph.edges_directed(u, dir)) {
+            auto const cost = weight_fn(edge);
+            assert(!(cost < W()) && "bidirectional_dijkstra requires non-negative edge costs");
+            auto const v = forward ? edge.target() : edge.source();
+            auto const candidate = current.priority + static_cast<W>(cost);
+            self.touch(v);
+            if (candidate < self.distance[v.index()]) {
+                self.distance[v.index()] = candidate;
+                self.parent[v.index()] = u;
+                self.parent_edge[v.index()] = edge.id();
+                self.queue.push_or_decrease(static_cast<Ix>(v.index()), candidate);
+            }
+            if (other.reachable(v)) {
+                auto const through = self.distance[v.index()] + other.distance[v.index()];
+                if (through < result.distance) {
+                    result.distance = through;
+                    meet = v;
+                }
+            }
+        }
+    }
+
+    if (result.found()) {
+        detail::append_tree_path(ws.forward, meet, false, result);
+        result.nodes.push_back(meet);
+        detail::append_tree_path(ws.backward, meet, true, result);
+    }
+    return result;
+}
+
+template <typename G, typename F>
+ShortestPath<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>>
+bidirectional_dijkstra(G const& graph, NodeIndex<typename G::index_t> source, NodeIndex<typename G::index_t> target, F&& weight_fn)
+{
+    BidirectionalWorkspace<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>> ws;
+    return bidirectional_dijkstra(graph, source, target, std::forward<F>(weight_fn), ws);
+}
+
+/// A* search from `source` to `target`. `heuristic(v)` estimates the cost
+/// from `v` to the target and must be consistent: never more than
+/// `weight_fn(e) + heuristic(w)` for an edge `e` from `v` to `w`, and zero at
+/// the target. With a consistent heuristic every node is settled at most once
+/// and the search stops as soon as the target is settled. A heuristic that is
+/// only admissible still gives exact answers, but nodes may be reopened. A
+/// zero heuristic makes this a plain target-directed Dijkstra.
+/// Distances from the source stay in `ws` for the settled nodes.
+template <typename G, typename F, typename H, typename W, typename A>
+ShortestPath<typename G::index_t, W>
+astar(G const& graph, NodeIndex<typename G::index_t> source, NodeIndex<typename G::index_t> target,
+      F&& weight_fn, H&& heuristic, SearchWorkspace<typename G::index_t, W, A>& ws)
+{
+    using Ix = typename G::index_t;
+    using Mark = typename SearchWorkspace<Ix, W, A>::Mark;
+
+    ShortestPath<Ix, W> result;
+    ws.begin(graph.node_count());
+    ws.source = source;
+    ws.touch(source);
+    ws.distance[source.index()] = W();
+    ws.queue.push_or_decrease(static_cast<Ix>(source.index()), W(heuristic(source)));
+
+    while (!ws.queue.empty()) {
+        auto const u = NodeIndex<Ix>(ws.queue.pop().key);
+        ws.mark[u.index()] = Mark::Done;
+        ++result.settled;
+        if (u == target) {
+            break;
+        }
+        auto const reached = ws.distance[u.index()];
+        for (auto const& edge : graph.edges_of(u)) {
+            auto const cost = weight_fn(edge);
+            assert(!(cost < W()) && "astar requires non-negative edge costs");
+            auto const v = edge.target();
+            auto const candidate = reached + static_cast<W>(cost);
+            ws.touch(v);
+            if (candidate < ws.distance[v.index()]) {
+                ws.mark[v.index()] = Mark::Seen;
+                ws.distance[v.index()] = candidate;
+                ws.parent[v.index()] = u;
+                ws.parent_edge[v.index()] = edge.id();
+                ws.queue.push_or_decrease(static_cast<Ix>(v.index()), candidate + W(heuristic(v)));
+            }
+        }
+    }
+
+    if (ws.mark_of(target) == Mark::Done) {
+        result.distance = ws.distance[target.index()];
+        detail::append_tree_path(ws, target, false, result);
+        result.nodes.push_back(target);
+    }
+    return result;
+}
+
+template <typename G, typename F, typename H>
+ShortestPath<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>>
+astar(G const& graph, NodeIndex<typename G::index_t> source, NodeIndex<typename G::index_t> target, F&& weight_fn, H&& heuristic)
+{
+    SearchWorkspace<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>> ws;
+    return astar(graph, source, target, std::forward<F>(weight_fn), std::forward<H>(heuristic), ws);
+}
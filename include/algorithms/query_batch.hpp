@@ -0,0 +1,109 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/point_to_point.hpp"
+#include "algorithms/search_workspace.hpp"
+#include "parallel/thread_pool.hpp"
+#include "visit/bfsvisit.hpp"
+
+#include <utility>
+#include <vector>
+
+/// Runs many independent queries against one shared, read-only graph on a
+/// ThreadPool.
+///
+/// The graph is only read through const member functions, which every graph
+/// type in the library supports from any number of threads at once, as long
+/// as nobody mutates it meanwhile. Each worker owns one `State`, reused across
+/// queries and across batches, so a warmed-up batch does not allocate beyond
+/// its results. Queries are scheduled with ThreadPool::steal_for, so a few
+/// long searches do not leave the other workers idle, and results always come
+/// back in query order.
+///
+/// Every State allocates through a copy of `alloc`. Workers grow their states
+/// concurrently, so the allocator must be safe to use from several threads;
+/// ArenaAllocator is not.
+template <typename G, typename W = double, typename Alloc = std::allocator<char>>
+struct QueryBatch
+{
+    using index_t = typename G::index_t;
+    using query_t = std::pair<NodeIndex<index_t>, NodeIndex<index_t>>;
+
+    /// Per-worker search state.
+    struct State
+    {
+        explicit State(Alloc const& alloc)
+        : search(alloc)
+        {
+        }
+
+        BidirectionalWorkspace<index_t, W, Alloc> search;
+    };
+
+    QueryBatch(G const& graph, ThreadPool& pool, std::size_t grain = 8, Alloc const& alloc = Alloc())
+    : graph(graph)
+    , pool(pool)
+    , grain(grain)
+    {
+        // Built in place rather than copied: copies of a container may pick a
+        // different allocator (std::pmr falls back to the default resource).
+        states.reserve(pool.size());
+        for (std::size_t i = 0; i < pool.size(); ++i) {
+            states.emplace_back(alloc);
+        }
+    }
+
+    /// Calls `fn(graph, query, state)` for every query and returns the
+    /// results in query order. `fn` runs concurrently on different workers
+    /// and must not touch shared mutable data without synchronisation.
+    template <typename F>
+    auto run(std::vector<query_t> const& queries, F&& fn)
+        -> std::vector<decltype(fn(std::declval<G const&>(), std::declval<query_t const&>(), std::declval<State&>()))>
+    {
+        using R = decltype(fn(graph, std::declval<query_t const&>(), states[0]));
+
+        // Workers write whole slots, never a shared word: a plain
+        // std::vector<R> would pack bool results into bits.
+        struct Slot
+        {
+            R value;
+        };
+        std::vector<Slot> slots(queries.size());
+        pool.steal_for(0, queries.size(), grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            for (auto i = first; i < last; ++i) {
+                slots[i].value = fn(graph, queries[i], states[id]);
+            }
+        });
+
+        std::vector<R> results;
+        results.reserve(slots.size());
+        for (auto& slot : slots) {
+            results.push_back(std::move(slot.value));
+        }
+        return results;
+    }
+
+    /// Bidirectional Dijkstra for every query under `weight_fn`.
+    template <typename F>
+    std::vector<ShortestPath<index_t, W>> shortest_paths(std::vector<query_t> const& queries, F const& weight_fn)
+    {
+        return run(queries, [&](G const& g, query_t const& q, State& state) {
+            return bidirectional_dijkstra(g, q.first, q.second, weight_fn, state.search);
+        });
+    }
+
+    /// Whether each query's target can be reached from its source, by a
+    /// breadth-first search that stops at the target.
+    std::vector<bool> reachable(std::vector<query_t> const& queries)
+    {
+        return run(queries, [](G const& g, query_t const& q, State& state) {
+            breadth_first_search(g, q.first, state.search.forward, q.second);
+            return state.search.forward.reachable(q.second);
+        });
+    }
+
+    G const& graph;
+    ThreadPool& pool;
+    std::size_t grain;
+    std::vector<State> states;
+};
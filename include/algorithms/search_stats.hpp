@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/// Which search produced a set of counters.
+enum class SearchKind : std::uint8_t {
+    BreadthFirst,
+    DepthFirst,
+    Dijkstra
+};
+
+/// What one query did. Edges are counted every time a search looks at one,
+/// whether or not it improves anything. The frontier is the BFS queue, the
+/// DFS stack or the Dijkstra heap.
+struct SearchCounters
+{
+    std::size_t nodes_discovered = 0;
+    std::size_t nodes_settled = 0;
+    std::size_t edges_relaxed = 0;
+    std::size_t heap_pushes = 0;
+    std::size_t heap_decreases = 0;
+    std::size_t peak_frontier = 0;
+};
+
+/// Stats policy of breadth_first_search(), depth_first_search() and
+/// dijkstra(), which call these members as they go. Every member is an empty
+/// inline function, so a search instantiated with NoStats compiles to the
+/// same code as one without any instrumentation; it is what the overloads
+/// without a stats argument use.
+struct NoStats
+{
+    static constexpr bool enabled = false;
+
+    void begin(SearchKind)
+    {
+    }
+
+    void discover()
+    {
+    }
+
+    void settle()
+    {
+    }
+
+    void relax()
+    {
+    }
+
+    void push()
+    {
+    }
+
+    void decrease()
+    {
+    }
+
+    void frontier(std::size_t)
+    {
+    }
+
+    void end()
+    {
+    }
+};
+
+/// Counts the work of the last query run with it. begin() clears the
+/// counters, so one instance can be reused across queries.
+struct SearchStats
+{
+    static constexpr bool enabled = true;
+
+    void begin(SearchKind search)
+    {
+        kind = search;
+        counters = SearchCounters();
+    }
+
+    void discover()
+    {
+        ++counters.nodes_discovered;
+    }
+
+    void settle()
+    {
+        ++counters.nodes_settled;
+    }
+
+    void relax()
+    {
+        ++counters.edges_relaxed;
+    }
+
+    void push()
+    {
+        ++counters.heap_pushes;
+    }
+
+    void decrease()
+    {
+        ++counters.heap_decreases;
+    }
+
+    void frontier(std::size_t size)
+    {
+        counters.peak_frontier = std::max(counters.peak_frontier, size);
+    }
+
+    void end()
+    {
+    }
+
+    SearchKind kind = SearchKind::BreadthFirst;
+    SearchCounters counters;
+};
+
+/// Reported to a TracedStats hook when a query finishes.
+struct SearchTrace
+{
+    SearchKind kind;
+    SearchCounters counters;
+    std::chrono::steady_clock::duration elapsed;
+};
+
+/// SearchStats that also times each query and hands the result to
+/// `hook(SearchTrace const&)`, e.g. to export it to a metrics system. The
+/// hook runs on the searching thread, after the search is done.
+template <typename Hook>
+struct TracedStats : SearchStats
+{
+    explicit TracedStats(Hook hook)
+    : hook(std::move(hook))
+    {
+    }
+
+    void begin(SearchKind search)
+    {
+        SearchStats::begin(search);
+        started = std::chrono::steady_clock::now();
+    }
+
+    void end()
+    {
+        hook(SearchTrace{kind, counters, std::chrono::steady_clock::now() - started});
+    }
+
+    Hook hook;
+    std::chrono::steady_clock::time_point started;
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/indexed_heap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// Epoch-stamped node marks alone, for searches that need no distances,
+/// parents or queue, depth-first search in particular. Resetting works as in
+/// SearchWorkspace, and so does `Alloc`.
+template <typename Ix, typename Alloc = std::allocator<char>>
+struct MarkWorkspace
+{
+    using stamp_t = std::uint32_t;
+    using allocator_type = Alloc;
+
+    MarkWorkspace() = default;
+
+    explicit MarkWorkspace(Alloc const& alloc)
+    : stamp(alloc)
+    , mark(alloc)
+    {
+    }
+
+    /// Same values as SearchWorkspace::Mark.
+    enum Mark : std::uint8_t {
+        Unseen = 0,
+        Seen = 1,
+        Done = 2
+    };
+
+    void begin(std::size_t node_count)
+    {
+        if (stamp.size() < node_count) {
+            stamp.resize(node_count, 0);
+            mark.resize(node_count);
+        }
+        if (++epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool touched(NodeIndex<Ix> v) const
+    {
+        return stamp[v.index()] == epoch;
+    }
+
+    Mark mark_of(NodeIndex<Ix> v) const
+    {
+        return touched(v) ? static_cast<Mark>(mark[v.index()]) : Unseen;
+    }
+
+    void set_mark(NodeIndex<Ix> v, Mark m)
+    {
+        stamp[v.index()] = epoch;
+        mark[v.index()] = m;
+    }
+
+    stamp_t epoch = 0;
+    std::vector<stamp_t, rebind_alloc_t<Alloc, stamp_t>> stamp;
+    std::vector<std::uint8_t, rebind_alloc_t<Alloc, std::uint8_t>> mark;
+};
+
+/// Per-thread scratch state for graph searches. Arrays are indexed by
+/// NodeIndex::index() and only grow, so once a workspace has seen the
+/// largest graph it is used with, back-to-back queries do not allocate.
+///
+/// Every node slot carries the epoch in which it was last written. Starting a
+/// query bumps the epoch, which invalidates all slots at once; a slot is
+/// re-initialised lazily the first time the query touches it. Resetting is
+/// therefore O(1) plus the leftover queue entries of an aborted search.
+///
+/// Every array, the queue's included, is allocated through `Alloc`.
+template <typename Ix, typename W = double, typename Alloc = std::allocator<char>>
+struct SearchWorkspace
+{
+    using stamp_t = std::uint32_t;
+    using allocator_type = Alloc;
+
+    SearchWorkspace() = default;
+
+    explicit SearchWorkspace(Alloc const& alloc)
+    : stamp(alloc)
+    , mark(alloc)
+    , distance(alloc)
+    , parent(alloc)
+    , parent_edge(alloc)
+    , queue(alloc)
+    , frontier(alloc)
+    {
+    }
+
+    /// Per-node marks used by the traversals: DFS colors, BFS visited, and
+    /// whether Dijkstra has settled a node.
+    enum Mark : std::uint8_t {
+        Unseen = 0,
+        Seen = 1,
+        Done = 2
+    };
+
+    static W infinity()
+    {
+        return std::numeric_limits<W>::max();
+    }
+
+    /// Prepares the workspace for a new query on a graph with `node_count`
+    /// nodes.
+    void begin(std::size_t node_count)
+    {
+        if (stamp.size() < node_count) {
+            stamp.resize(node_count, 0);
+            mark.resize(node_count);
+            distance.resize(node_count);
+            parent.resize(node_count);
+            parent_edge.resize(node_count);
+        }
+        if (++epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+        queue.clear(node_count);
+        frontier.clear();
+        source = NodeIndex<Ix>::end();
+    }
+
+    bool touched(NodeIndex<Ix> v) const
+    {
+        return stamp[v.index()] == epoch;
+    }
+
+    /// Makes `v`'s slot valid for the current query, initialising it to
+    /// unseen, unreached and parentless on first use.
+    void touch(NodeIndex<Ix> v)
+    {
+        auto const i = v.index();
+        if (stamp[i] != epoch) {
+            stamp[i] = epoch;
+            mark[i] = Unseen;
+            distance[i] = infinity();
+            parent[i] = NodeIndex<Ix>::end();
+            parent_edge[i] = EdgeIndex<Ix>::end();
+        }
+    }
+
+    Mark mark_of(NodeIndex<Ix> v) const
+    {
+        return touched(v) ? static_cast<Mark>(mark[v.index()]) : Unseen;
+    }
+
+    void set_mark(NodeIndex<Ix> v, Mark m)
+    {
+        touch(v);
+        mark[v.index()] = m;
+    }
+
+    bool reachable(NodeIndex<Ix> v) const
+    {
+        return touched(v) && distance[v.index()] != infinity();
+    }
+
+    W distance_to(NodeIndex<Ix> v) const
+    {
+        return touched(v) ? distance[v.index()] : infinity();
+    }
+
+    NodeIndex<Ix> parent_of(NodeIndex<Ix> v) const
+    {
+        return touched(v) ? parent[v.index()] : NodeIndex<Ix>::end();
+    }
+
+    EdgeIndex<Ix> parent_edge_of(NodeIndex<Ix> v) const
+    {
+        return touched(v) ? parent_edge[v.index()] : EdgeIndex<Ix>::end();
+    }
+
+    /// Nodes on the recorded path from the source to `v`, inclusive. Empty if
+    /// `v` was not reached.
+    std::vector<NodeIndex<Ix>> path_to(NodeIndex<Ix> v) const
+    {
+        std::vector<NodeIndex<Ix>> path;
+        if (!reachable(v)) {
+            return path;
+        }
+        for (auto u = v; u != NodeIndex<Ix>::end(); u = parent_of(u)) {
+            path.push_back(u);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    NodeIndex<Ix> source;
+    stamp_t epoch = 0;
+    std::vector<stamp_t, rebind_alloc_t<Alloc, stamp_t>> stamp;
+    std::vector<std::uint8_t, rebind_alloc_t<Alloc, std::uint8_t>> mark;
+    std::vector<W, rebind_alloc_t<Alloc, W>> distance;
+    std::vector<NodeIndex<Ix>, rebind_alloc_t<Alloc, NodeIndex<Ix>>> parent;
+    std::vector<EdgeIndex<Ix>, rebind_alloc_t<Alloc, EdgeIndex<Ix>>> parent_edge;
+    IndexedHeap<Ix, W, 4, Alloc> queue;
+    std::vector<NodeIndex<Ix>, rebind_alloc_t<Alloc, NodeIndex<Ix>>> frontier;
+};
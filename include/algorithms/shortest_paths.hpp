@@ -0,0 +1,157 @@
+#pragma once
+
+#include "graph.hpp"
+#include "algorithms/bucket_queue.hpp"
+#include "algorithms/cost_traits.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/search_workspace.hpp"
+#include "visit/bfsvisit.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+/// Stand-in queue for the kinds that use the workspace's own queue.
+template <typename Alloc>
+struct NoCostQueue
+{
+    NoCostQueue() = default;
+
+    explicit NoCostQueue(Alloc const&)
+    {
+    }
+};
+
+template <typename Ix, typename W, typename Alloc, CostKind kind = cost_traits<W>::kind>
+struct cost_queue
+{
+    using type = NoCostQueue<Alloc>;
+};
+
+template <typename Ix, typename W, typename Alloc>
+struct cost_queue<Ix, W, Alloc, CostKind::SmallInteger>
+{
+    using type = DialQueue<Ix, cost_distance_t<W>, std::size_t(std::numeric_limits<W>::max()) + 1, Alloc>;
+};
+
+template <typename Ix, typename W, typename Alloc>
+struct cost_queue<Ix, W, Alloc, CostKind::Integer>
+{
+    using type = RadixHeap<Ix, cost_distance_t<W>, Alloc>;
+};
+
+/// Dijkstra over a monotone bucket queue without decrease-key: improved
+/// nodes are pushed again and stale entries skipped when popped.
+template <typename G, typename F, typename D, typename A, typename Q>
+void bucket_search(G const& graph, NodeIndex<typename G::index_t> start, F& weight_fn, SearchWorkspace<typename G::index_t, D, A>& ws,
+                   Q& queue, NodeIndex<typename G::index_t> target)
+{
+    using Ix = typename G::index_t;
+    using Mark = typename SearchWorkspace<Ix, D, A>::Mark;
+
+    ws.begin(graph.node_count());
+    ws.source = start;
+    ws.touch(start);
+    ws.distance[start.index()] = D();
+    queue.clear();
+    queue.push(static_cast<Ix>(start.index()), D());
+
+    while (!queue.empty()) {
+        auto const current = queue.pop();
+        auto const i = static_cast<std::size_t>(current.key);
+        if (ws.mark[i] == Mark::Done || current.priority != ws.distance[i]) {
+            continue;
+        }
+        ws.mark[i] = Mark::Done;
+        auto const u = NodeIndex<Ix>(current.key);
+        if (u == target) {
+            break;
+        }
+        for (auto const& edge : graph.edges_of(u)) {
+            auto const cost = weight_fn(edge);
+            assert(!(cost < edge_cost_t<G, F>()) && "shortest_paths requires non-negative edge costs");
+            auto const v = edge.target();
+            auto const candidate = current.priority + static_cast<D>(cost);
+            ws.touch(v);
+            if (candidate < ws.distance[v.index()]) {
+                ws.distance[v.index()] = candidate;
+                ws.parent[v.index()] = u;
+                ws.parent_edge[v.index()] = edge.id();
+                queue.push(static_cast<Ix>(v.index()), candidate);
+            }
+        }
+    }
+}
+
+}
+
+/// SearchWorkspace for shortest_paths() with edge cost type `W`, plus the
+/// bucket queue its kind needs.
+template <typename Ix, typename W, typename Alloc = std::allocator<char>>
+struct ShortestPathWorkspace : SearchWorkspace<Ix, cost_distance_t<W>, Alloc>
+{
+    using cost_t = W;
+
+    ShortestPathWorkspace() = default;
+
+    explicit ShortestPathWorkspace(Alloc const& alloc)
+    : SearchWorkspace<Ix, cost_distance_t<W>, Alloc>(alloc)
+    , buckets(alloc)
+    {
+    }
+
+    typename detail::cost_queue<Ix, W, Alloc>::type buckets;
+};
+
+/// Single-source shortest paths from `start` with the search picked at
+/// compile time from the cost type `weight_fn` returns (see cost_traits):
+/// breadth-first search for unit costs, Dial's buckets for 8-bit integers,
+/// a radix heap for wider integers and dijkstra() otherwise. Integer costs
+/// never go through a comparison heap or floating point. Distances and the
+/// tree go to `ws` as with dijkstra(), and `target` stops the search the
+/// same way. Costs must be non-negative.
+template <typename G, typename F, typename W, typename A>
+void shortest_paths(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+                    ShortestPathWorkspace<typename G::index_t, W, A>& ws,
+                    NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    static_assert(std::is_same<W, edge_cost_t<G, F>>::value, "workspace cost type must match what weight_fn returns");
+
+    constexpr auto kind = cost_traits<W>::kind;
+    if constexpr (kind == CostKind::Unit) {
+        breadth_first_search(graph, start, ws, target);
+    }
+    else if constexpr (kind == CostKind::General) {
+        dijkstra(graph, start, std::forward<F>(weight_fn), ws, target);
+    }
+    else {
+        detail::bucket_search(graph, start, weight_fn, ws, ws.buckets, target);
+    }
+}
+
+/// Same search, with the answer copied into a dense DijkstraResult.
+template <typename G, typename F>
+DijkstraResult<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>>
+shortest_paths(G const& graph, NodeIndex<typename G::index_t> start, F&& weight_fn,
+               NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    ShortestPathWorkspace<typename G::index_t, edge_cost_t<G, F>> ws;
+    shortest_paths(graph, start, std::forward<F>(weight_fn), ws, target);
+    DijkstraResult<typename G::index_t, cost_distance_t<edge_cost_t<G, F>>> result;
+    result.assign(ws, graph.node_count());
+    return result;
+}
+
+/// Shortest paths under the graph's own edge weights; `E = void` graphs
+/// count hops.
+template <typename G>
+DijkstraResult<typename G::index_t, cost_distance_t<typename G::edge_weight_t>>
+shortest_paths(G const& graph, NodeIndex<typename G::index_t> start)
+{
+    return shortest_paths(graph, start, [](typename G::edge_reference_t const& edge) { return edge.weight(); });
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "graph.hpp"
+#include "parallel/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+template <typename E, typename A, typename B>
+E bulk_edge_weight(std::pair<A, B> const&)
+{
+    return E();
+}
+
+template <typename E, typename A, typename B>
+E bulk_edge_weight(std::tuple<A, B> const&)
+{
+    return E();
+}
+
+template <typename E, typename A, typename B, typename C>
+E bulk_edge_weight(std::tuple<A, B, C> const& item)
+{
+    return std::get<2>(item);
+}
+
+/// Whether `id` is a valid node index for `Ix`. Checked on the raw value,
+/// since narrowing to `Ix` first would wrap large ids into range.
+template <typename Ix, typename T>
+bool endpoint_fits(T id)
+{
+    if constexpr (std::is_signed<T>::value) {
+        if (id < 0) {
+            return false;
+        }
+    }
+    return static_cast<std::size_t>(id) < std::numeric_limits<Ix>::max();
+}
+
+/// Copies `edge_list` into `graph.edges` unlinked and sizes `graph.nodes` to
+/// cover every endpoint.
+template <typename G, typename Range>
+void fill_unlinked(G& graph, Range const& edge_list, std::size_t node_count)
+{
+    using Ix = typename G::index_t;
+    using E = typename G::edge_weight_t;
+
+    graph.edges.reserve(graph.edges.size() + edge_list.size());
+    for (auto const& item : edge_list) {
+        if (!endpoint_fits<Ix>(std::get<0>(item)) || !endpoint_fits<Ix>(std::get<1>(item))) {
+            throw std::invalid_argument("edge endpoint does not fit the index type");
+        }
+        auto const u = static_cast<std::size_t>(std::get<0>(item));
+        auto const v = static_cast<std::size_t>(std::get<1>(item));
+        auto const a = NodeIndex<Ix>(static_cast<Ix>(u));
+        auto const b = NodeIndex<Ix>(static_cast<Ix>(v));
+        node_count = std::max(node_count, std::max(u, v) + 1);
+        graph.edges.push_back(Edge<E, Ix>({{a, b}}, bulk_edge_weight<E>(item)));
+    }
+    if (node_count >= std::numeric_limits<Ix>::max()) {
+        throw std::invalid_argument("node count does not fit the index type");
+    }
+    assert(graph.edges.size() < std::numeric_limits<Ix>::max() && "edge index space exhausted");
+    graph.nodes.resize(node_count);
+}
+
+}
+
+/// Links every edge of `graph` into the chains of its endpoints, in edge
+/// order, assuming all chain heads and links are still empty. The result is
+/// what calling add_edge for each edge in turn would have produced.
+template <typename G>
+void link_edges(G& graph)
+{
+    using Ix = typename G::index_t;
+
+    for (std::size_t i = 0; i < graph.edges.size(); ++i) {
+        auto& edge = graph.edges.links(i);
+        auto const e = EdgeIndex<Ix>(static_cast<Ix>(i));
+        for (std::size_t k = 0; k < 2; ++k) {
+            auto& head = graph.nodes[edge.node[k].index()].next[k];
+            edge.next[k] = head;
+            head = e;
+        }
+    }
+}
+
+/// Parallel variant of link_edges. Edges are bucketed by endpoint with an
+/// atomic counting sort, each bucket is put back into insertion order, and
+/// every bucket is linked into its node's chain independently.
+template <typename G>
+void link_edges(G& graph, ThreadPool& pool)
+{
+    using Ix = typename G::index_t;
+
+    if (pool.size() == 1) {
+        link_edges(graph);
+        return;
+    }
+
+    auto const n = graph.nodes.size();
+    auto const m = graph.edges.size();
+    std::size_t const grain = 1 << 14;
+
+    std::vector<std::atomic<std::size_t>> cursor(n + 1);
+    std::vector<std::size_t> offsets(n + 1);
+    std::vector<Ix> bucket(m);
+
+    for (std::size_t k = 0; k < 2; ++k) {
+        for (auto& c : cursor) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        pool.parallel_for(0, m, grain, [&](std::size_t first, std::size_t last, std::size_t) {
+            for (auto i = first; i < last; ++i) {
+                cursor[graph.edges.links(i).node[k].index() + 1].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        offsets[0] = 0;
+        for (std::size_t u = 0; u < n; ++u) {
+            offsets[u + 1] = offsets[u] + cursor[u + 1].load(std::memory_order_relaxed);
+            cursor[u].store(offsets[u], std::memory_order_relaxed);
+        }
+        pool.parallel_for(0, m, grain, [&](std::size_t first, std::size_t last, std::size_t) {
+            for (auto i = first; i < last; ++i) {
+                auto const slot = cursor[graph.edges.links(i).node[k].index()].fetch_add(1, std::memory_order_relaxed);
+                bucket[slot] = static_cast<Ix>(i);
+            }
+        });
+        pool.parallel_for(0, n, grain, [&](std::size_t first, std::size_t last, std::size_t) {
+            for (auto u = first; u < last; ++u) {
+                auto const begin = bucket.begin() + offsets[u];
+                auto const end = bucket.begin() + offsets[u + 1];
+                std::sort(begin, end);
+                auto prev = EdgeIndex<Ix>::end();
+                for (auto it = begin; it != end; ++it) {
+                    graph.edges.links(*it).next[k] = prev;
+                    prev = EdgeIndex<Ix>(*it);
+                }
+                graph.nodes[u].next[k] = prev;
+            }
+        });
+    }
+}
+
+/// Builds a graph from a sized range of `(source, target)` or
+/// `(source, target, weight)` pairs/tuples in one pass over the edges. Nodes
+/// are created with default weights up to the larger of `node_count` and the
+/// highest endpoint. The result is identical, chain links included, to
+/// adding the same nodes and then the edges one by one with add_edge.
+/// Throws std::invalid_argument if an endpoint or the node count does not
+/// fit the graph's index type.
+template <typename G, typename Range>
+G from_edges(Range const& edge_list, std::size_t node_count = 0)
+{
+    G graph;
+    detail::fill_unlinked(graph, edge_list, node_count);
+    link_edges(graph);
+    return graph;
+}
+
+/// Same as from_edges, with every vector of the graph allocated through
+/// `alloc`.
+template <typename G, typename Range>
+G from_edges(Range const& edge_list, std::size_t node_count, typename G::allocator_type const& alloc)
+{
+    G graph(alloc);
+    detail::fill_unlinked(graph, edge_list, node_count);
+    link_edges(graph);
+    return graph;
+}
+
+/// Same as from_edges, with the chains linked in parallel on `pool`.
+template <typename G, typename Range>
+G from_edges(Range const& edge_list, std::size_t node_count, ThreadPool& pool)
+{
+    G graph;
+    detail::fill_unlinked(graph, edge_list, node_count);
+    link_edges(graph, pool);
+    return graph;
+}
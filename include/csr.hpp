@@ -0,0 +1,232 @@
+#pragma once
+
+#include "graph.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/// Iterates one node's slice of a CsrGraph adjacency array, yielding the same
+/// EdgeReference type as Graph so algorithms can consume either layout.
+template <typename E, typename Ix>
+struct CsrEdgesIterator
+{
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = EdgeReference<E, Ix>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type;
+
+    CsrEdgesIterator(NodeIndex<Ix> node, std::size_t pos, NodeIndex<Ix> const* targets,
+                     EdgeIndex<Ix> const* ids, E const* weights, bool incoming)
+    : node(node)
+    , pos(pos)
+    , targets(targets)
+    , ids(ids)
+    , weights(weights)
+    , incoming(incoming)
+    {
+    }
+
+    reference operator*() const
+    {
+        auto ref = EdgeReference<E, Ix>();
+        ref.index = ids[pos];
+        ref.node = incoming ? std::array<NodeIndex<Ix>, 2>{{targets[pos], node}} : std::array<NodeIndex<Ix>, 2>{{node, targets[pos]}};
+        ref.weight_ptr = &weights[pos];
+        return ref;
+    }
+
+    CsrEdgesIterator& operator++()
+    {
+        ++pos;
+        return *this;
+    }
+
+    bool operator==(CsrEdgesIterator const& other) const
+    {
+        return pos == other.pos;
+    }
+
+    bool operator!=(CsrEdgesIterator const& other) const
+    {
+        return pos != other.pos;
+    }
+
+    NodeIndex<Ix> node;
+    std::size_t pos;
+    NodeIndex<Ix> const* targets;
+    EdgeIndex<Ix> const* ids;
+    E const* weights;
+    bool incoming;
+};
+
+/// One direction of adjacency in compressed sparse row form. The neighbors of
+/// node `u` live in `[offsets[u], offsets[u + 1])` of the parallel arrays.
+template <typename E, typename Ix>
+struct CsrAdjacency
+{
+    std::vector<std::size_t> offsets;
+    std::vector<NodeIndex<Ix>> targets;
+    std::vector<EdgeIndex<Ix>> ids;
+    std::vector<E> weights;
+};
+
+/// Immutable snapshot of a Graph laid out as contiguous offset/target/weight
+/// arrays. Node and edge indices are the same as in the source graph. Within
+/// a node, neighbors are ordered by ascending EdgeIndex. Undirected graphs
+/// store a single adjacency that lists every edge from both endpoints.
+template <typename N, typename E_, bool directed, typename Ix>
+struct CsrGraph
+{
+    using E = edge_weight_type_t<E_>;
+    using node_weight_t = N;
+    using edge_weight_t = E;
+    using index_t = Ix;
+    using edge_reference_t = EdgeReference<E, Ix>;
+    using edges_iterator_t = CsrEdgesIterator<E, Ix>;
+
+    CsrGraph()
+    {
+    }
+
+    template <typename Storage, typename Alloc>
+    explicit CsrGraph(Graph<N, E_, directed, Ix, Storage, Alloc> const& graph)
+    {
+        if (graph.has_vacancies()) {
+            throw std::logic_error("compact() the graph before freezing it");
+        }
+        auto const n = graph.node_count();
+        auto const m = graph.edge_count();
+
+        node_weights.reserve(n);
+        for (auto const& node : graph.nodes) {
+            node_weights.push_back(node.weight);
+        }
+        edge_weights.reserve(m);
+        endpoints.reserve(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            edge_weights.push_back(graph.edges.weight(i));
+            endpoints.push_back(graph.edges.links(i).node);
+        }
+
+        build(Direction::Direction::Outgoing);
+        if (directed) {
+            build(Direction::Direction::Ingoing);
+        }
+    }
+
+    std::size_t node_count() const
+    {
+        return node_weights.size();
+    }
+
+    std::size_t edge_count() const
+    {
+        return edge_weights.size();
+    }
+
+    bool is_directed() const
+    {
+        return directed;
+    }
+
+    N const& node_weight(NodeIndex<Ix> a) const
+    {
+        return node_weights[a.index()];
+    }
+
+    E const& edge_weight(EdgeIndex<Ix> e) const
+    {
+        return edge_weights[e.index()];
+    }
+
+    std::pair<NodeIndex<Ix>, NodeIndex<Ix>> edge_endpoints(EdgeIndex<Ix> e) const
+    {
+        auto const& ed = endpoints[e.index()];
+        return std::make_pair(ed[0], ed[1]);
+    }
+
+    std::size_t degree(NodeIndex<Ix> a, Direction::Direction dir = Direction::Direction::Outgoing) const
+    {
+        auto const& offsets = adjacency(dir).offsets;
+        return offsets[a.index() + 1] - offsets[a.index()];
+    }
+
+    IteratorRange<edges_iterator_t> edges_of(NodeIndex<Ix> a) const
+    {
+        return edges_directed(a, Direction::Direction::Outgoing);
+    }
+
+    IteratorRange<edges_iterator_t> edges_directed(NodeIndex<Ix> a, Direction::Direction dir) const
+    {
+        auto const& row = adjacency(dir);
+        bool const incoming = dir == Direction::Direction::Ingoing;
+        auto const first = row.offsets[a.index()];
+        auto const last = row.offsets[a.index() + 1];
+        return {edges_iterator_t(a, first, row.targets.data(), row.ids.data(), row.weights.data(), incoming),
+                edges_iterator_t(a, last, row.targets.data(), row.ids.data(), row.weights.data(), incoming)};
+    }
+
+    /// Raw adjacency arrays, for kernels that want to scan them directly.
+    CsrAdjacency<E, Ix> const& adjacency(Direction::Direction dir) const
+    {
+        return directed ? adj[Direction::index(dir)] : adj[0];
+    }
+
+    std::vector<N> node_weights;
+    std::vector<E> edge_weights;
+    std::vector<std::array<NodeIndex<Ix>, 2>> endpoints;
+    std::array<CsrAdjacency<E, Ix>, 2> adj;
+
+private:
+    void build(Direction::Direction dir)
+    {
+        auto const k = Direction::index(dir);
+        auto const o = 1 - k;
+        auto& a = adj[k];
+        auto const n = node_weights.size();
+
+        a.offsets.assign(n + 1, 0);
+        for (auto const& ed : endpoints) {
+            ++a.offsets[ed[k].index() + 1];
+            if (!directed && ed[0] != ed[1]) {
+                ++a.offsets[ed[o].index() + 1];
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            a.offsets[i + 1] += a.offsets[i];
+        }
+
+        auto const total = a.offsets[n];
+        a.targets.resize(total);
+        a.ids.resize(total);
+        a.weights.resize(total);
+
+        std::vector<std::size_t> cursor(a.offsets.begin(), a.offsets.end() - 1);
+        for (std::size_t e = 0; e < endpoints.size(); ++e) {
+            auto const& ed = endpoints[e];
+            place(a, cursor[ed[k].index()]++, ed[o], e);
+            if (!directed && ed[0] != ed[1]) {
+                place(a, cursor[ed[o].index()]++, ed[k], e);
+            }
+        }
+    }
+
+    void place(CsrAdjacency<E, Ix>& a, std::size_t slot, NodeIndex<Ix> target, std::size_t e)
+    {
+        a.targets[slot] = target;
+        a.ids[slot] = EdgeIndex<Ix>(static_cast<Ix>(e));
+        a.weights[slot] = edge_weights[e];
+    }
+};
+
+/// Builds an immutable CSR snapshot of `graph` for read-heavy traversal.
+/// Throws std::logic_error if `graph` has vacancies; compact() it first.
+template <typename N, typename E, bool directed, typename Ix, typename Storage, typename Alloc>
+CsrGraph<N, E, directed, Ix> freeze(Graph<N, E, directed, Ix, Storage, Alloc> const& graph)
+{
+    return CsrGraph<N, E, directed, Ix>(graph);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 using DefaultIx = std::uint32_t;
 
@@ -17,14 +18,26 @@ struct NodeIndex;
 template <typename N, typename Ix = DefaultIx>
 struct Node;
 
-template <typename E, typename Ix = DefaultIx>
+template <typename E, typename Ix = DefaultIx, typename Enable = void>
 struct Edge;
 
-template <typename N, typename E = char, bool directed = true, typename Ix = DefaultIx>
+struct AosStorage;
+
+struct SoaStorage;
+
+template <typename N, typename E = char, bool directed = true, typename Ix = DefaultIx, typename Storage = AosStorage,
+          typename Alloc = std::allocator<char>>
 struct Graph;
 
-template <typename N, typename E, typename Ix = DefaultIx>
-using DiGraph = Graph<N, E, true, Ix>;
+template <typename N, typename E, typename Ix = DefaultIx, typename Storage = AosStorage, typename Alloc = std::allocator<char>>
+using DiGraph = Graph<N, E, true, Ix, Storage, Alloc>;
+
+template <typename N, typename E, typename Ix = DefaultIx, typename Storage = AosStorage, typename Alloc = std::allocator<char>>
+using UnGraph = Graph<N, E, false, Ix, Storage, Alloc>;
 
-template <typename N, typename E, typename Ix = DefaultIx>
-using UnGraph = Graph<N, E, false, Ix>;
+
+
+// csr.hpp
+
+template <typename N, typename E = char, bool directed = true, typename Ix = DefaultIx>
+struct CsrGraph;
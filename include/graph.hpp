@@ -6,8 +6,12 @@
 #include <array>
 #include <cassert>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 namespace Direction {
@@ -17,7 +21,7 @@ enum class Direction : std::uint8_t {
     Ingoing = 1
 };
 
-Direction opposite(Direction direction)
+inline Direction opposite(Direction direction)
 {
     switch (direction) {
     case Direction::Outgoing:
@@ -25,6 +29,7 @@ Direction opposite(Direction direction)
     case Direction::Ingoing:
         return Direction::Outgoing;
     }
+    return Direction::Outgoing;
 }
 
 constexpr std::size_t index(Direction direction)
@@ -45,6 +50,16 @@ struct NodeIndex
     {
     }
 
+    bool operator==(NodeIndex const& other) const
+    {
+        return _index == other._index;
+    }
+
+    bool operator!=(NodeIndex const& other) const
+    {
+        return _index != other._index;
+    }
+
     std::size_t index() const
     {
         return _index;
@@ -66,11 +81,23 @@ struct NodeIndex
 template <typename Ix>
 struct EdgeIndex
 {
+    using index_t = Ix;
+
     EdgeIndex(Ix index = std::numeric_limits<Ix>::max())
     : _index(index)
     {
     }
 
+    bool operator==(EdgeIndex const& other) const
+    {
+        return _index == other._index;
+    }
+
+    bool operator!=(EdgeIndex const& other) const
+    {
+        return _index != other._index;
+    }
+
     std::size_t index() const
     {
         return _index;
@@ -108,13 +135,14 @@ struct Node
     std::array<EdgeIndex<Ix>, 2> next;
 };
 
-template <typename E, typename Ix>
-struct Edge
+/// Topology of an edge: its endpoints and the next edge in each of their
+/// chains.
+template <typename Ix>
+struct EdgeLinks
 {
 
-    Edge(std::array<NodeIndex<Ix>, 2> node, E const& weight = {})
-    : weight(weight)
-    , next({EdgeIndex<Ix>::end(), EdgeIndex<Ix>::end()})
+    EdgeLinks(std::array<NodeIndex<Ix>, 2> node)
+    : next({EdgeIndex<Ix>::end(), EdgeIndex<Ix>::end()})
     , node(node)
     {
     }
@@ -124,24 +152,483 @@ struct Edge
         return next[Direction::index(dir)];
     }
 
-    EdgeIndex<Ix> source() const
+    NodeIndex<Ix> source() const
     {
         return node[0];
     }
 
-    EdgeIndex<Ix> target() const
+    NodeIndex<Ix> target() const
     {
         return node[1];
     }
 
-    E weight;
     std::array<EdgeIndex<Ix>, 2> next;
     std::array<NodeIndex<Ix>, 2> node;
 };
 
-template <typename N, typename E, bool directed, typename Ix>
+/// Edge weight used for graphs declared with `E = void`.
+struct NoWeight
+{
+    bool operator==(NoWeight const&) const
+    {
+        return true;
+    }
+
+    bool operator!=(NoWeight const&) const
+    {
+        return false;
+    }
+};
+
+template <typename E>
+using edge_weight_type_t = typename std::conditional<std::is_void<E>::value, NoWeight, E>::type;
+
+/// `Alloc` rebound to element type `T`, for containers that share one
+/// allocator parameter.
+template <typename Alloc, typename T>
+using rebind_alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+template <typename E, typename Ix, typename Enable>
+struct Edge : EdgeLinks<Ix>
+{
+
+    Edge(std::array<NodeIndex<Ix>, 2> node, E const& weight = {})
+    : EdgeLinks<Ix>(node)
+    , weight(weight)
+    {
+    }
+
+    E weight;
+};
+
+/// Edges with an empty weight type store no weight at all; every edge shares
+/// one static instance.
+template <typename E, typename Ix>
+struct Edge<E, Ix, typename std::enable_if<std::is_empty<E>::value>::type> : EdgeLinks<Ix>
+{
+
+    Edge(std::array<NodeIndex<Ix>, 2> node, E const& = {})
+    : EdgeLinks<Ix>(node)
+    {
+    }
+
+    static inline E weight{};
+};
+
+/// Default edge storage: one vector of Edge records, so an edge's links and
+/// weight share a cache line.
+template <typename E, typename Ix, typename Alloc = std::allocator<char>>
+struct AosEdgeStore
+{
+    using weight_t = E;
+    using index_t = Ix;
+    using value_type = Edge<E, Ix>;
+
+    explicit AosEdgeStore(Alloc const& alloc = Alloc())
+    : edges(alloc)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return edges.size();
+    }
+
+    bool empty() const
+    {
+        return edges.empty();
+    }
+
+    void reserve(std::size_t capacity)
+    {
+        edges.reserve(capacity);
+    }
+
+    void clear()
+    {
+        edges.clear();
+    }
+
+    /// Truncates to the first `count` edges; never grows the store.
+    void truncate(std::size_t count)
+    {
+        edges.erase(edges.begin() + static_cast<std::ptrdiff_t>(std::min(count, edges.size())), edges.end());
+    }
+
+    void push_back(Edge<E, Ix> const& edge)
+    {
+        edges.push_back(edge);
+    }
+
+    EdgeLinks<Ix>& links(std::size_t i)
+    {
+        return edges[i];
+    }
+
+    EdgeLinks<Ix> const& links(std::size_t i) const
+    {
+        return edges[i];
+    }
+
+    E& weight(std::size_t i)
+    {
+        return edges[i].weight;
+    }
+
+    E const& weight(std::size_t i) const
+    {
+        return edges[i].weight;
+    }
+
+    Edge<E, Ix>& operator[](std::size_t i)
+    {
+        return edges[i];
+    }
+
+    Edge<E, Ix> const& operator[](std::size_t i) const
+    {
+        return edges[i];
+    }
+
+    Edge<E, Ix> const* data() const
+    {
+        return edges.data();
+    }
+
+    std::vector<Edge<E, Ix>, rebind_alloc_t<Alloc, Edge<E, Ix>>> edges;
+};
+
+/// Structure-of-arrays edge storage: links and weights live in separate
+/// vectors, so walking chains without reading weights never loads them.
+/// Empty weight types get no weight vector at all.
+template <typename E, typename Ix, typename Alloc = std::allocator<char>>
+struct SoaEdgeStore
+{
+    using weight_t = E;
+    using index_t = Ix;
+    using value_type = Edge<E, Ix>;
+
+    static constexpr bool stores_weights = !std::is_empty<E>::value;
+
+    explicit SoaEdgeStore(Alloc const& alloc = Alloc())
+    : link_data(alloc)
+    , weights(alloc)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return link_data.size();
+    }
+
+    bool empty() const
+    {
+        return link_data.empty();
+    }
+
+    void reserve(std::size_t capacity)
+    {
+        link_data.reserve(capacity);
+        if constexpr (stores_weights) {
+            weights.reserve(capacity);
+        }
+    }
+
+    void clear()
+    {
+        link_data.clear();
+        weights.clear();
+    }
+
+    /// Truncates to the first `count` edges; never grows the store.
+    void truncate(std::size_t count)
+    {
+        link_data.erase(link_data.begin() + static_cast<std::ptrdiff_t>(std::min(count, link_data.size())), link_data.end());
+        if constexpr (stores_weights) {
+            weights.erase(weights.begin() + static_cast<std::ptrdiff_t>(std::min(count, weights.size())), weights.end());
+        }
+    }
+
+    void push_back(Edge<E, Ix> const& edge)
+    {
+        link_data.push_back(edge);
+        if constexpr (stores_weights) {
+            weights.push_back(edge.weight);
+        }
+    }
+
+    EdgeLinks<Ix>& links(std::size_t i)
+    {
+        return link_data[i];
+    }
+
+    EdgeLinks<Ix> const& links(std::size_t i) const
+    {
+        return link_data[i];
+    }
+
+    E& weight(std::size_t i)
+    {
+        if constexpr (stores_weights) {
+            return weights[i];
+        }
+        else {
+            return Edge<E, Ix>::weight;
+        }
+    }
+
+    E const& weight(std::size_t i) const
+    {
+        if constexpr (stores_weights) {
+            return weights[i];
+        }
+        else {
+            return Edge<E, Ix>::weight;
+        }
+    }
+
+    std::vector<EdgeLinks<Ix>, rebind_alloc_t<Alloc, EdgeLinks<Ix>>> link_data;
+    std::vector<E, rebind_alloc_t<Alloc, E>> weights;
+};
+
+/// Storage policies for Graph's edges.
+struct AosStorage
+{
+    template <typename E, typename Ix, typename Alloc = std::allocator<char>>
+    using edge_store = AosEdgeStore<E, Ix, Alloc>;
+};
+
+struct SoaStorage
+{
+    template <typename E, typename Ix, typename Alloc = std::allocator<char>>
+    using edge_store = SoaEdgeStore<E, Ix, Alloc>;
+};
+
+/// Read-only edge store over a contiguous array of Edge records, such as a
+/// memory-mapped file.
+template <typename E, typename Ix>
+struct EdgeArrayView
+{
+    using weight_t = E;
+    using index_t = Ix;
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    EdgeLinks<Ix> const& links(std::size_t i) const
+    {
+        return edges[i];
+    }
+
+    E const& weight(std::size_t i) const
+    {
+        return edges[i].weight;
+    }
+
+    Edge<E, Ix> const* edges;
+    std::size_t count;
+};
+
+/// Lightweight view of one edge as seen while walking the adjacency of a
+/// node. It is oriented so that `source()` is the node being walked when
+/// iterating outgoing edges and `target()` is that node when iterating
+/// ingoing edges; for directed graphs that is simply the stored orientation.
+template <typename E, typename Ix>
+struct EdgeReference
+{
+    EdgeIndex<Ix> id() const
+    {
+        return index;
+    }
+
+    NodeIndex<Ix> source() const
+    {
+        return node[0];
+    }
+
+    NodeIndex<Ix> target() const
+    {
+        return node[1];
+    }
+
+    E const& weight() const
+    {
+        return *weight_ptr;
+    }
+
+    EdgeIndex<Ix> index;
+    std::array<NodeIndex<Ix>, 2> node;
+    E const* weight_ptr;
+};
+
+/// Walks the intrusive edge chains of a single node. Undirected graphs walk
+/// the chain of the requested direction first and then the opposite one,
+/// skipping self loops the second time so they are only yielded once.
+/// `Store` is any edge store exposing `links(i)` and `weight(i)`.
+template <typename Store, bool directed>
+struct EdgesIterator
+{
+    using Ix = typename Store::index_t;
+    using E = typename Store::weight_t;
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = EdgeReference<E, Ix>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    EdgesIterator()
+    : edges(nullptr)
+    , dir(Direction::Direction::Outgoing)
+    , next({EdgeIndex<Ix>::end(), EdgeIndex<Ix>::end()})
+    , current()
+    {
+        current.index = EdgeIndex<Ix>::end();
+    }
+
+    EdgesIterator(Store const* edges, std::array<EdgeIndex<Ix>, 2> next, Direction::Direction dir)
+    : edges(edges)
+    , dir(dir)
+    , next(next)
+    , current()
+    {
+        advance();
+    }
+
+    reference operator*() const
+    {
+        return current;
+    }
+
+    pointer operator->() const
+    {
+        return &current;
+    }
+
+    EdgesIterator& operator++()
+    {
+        advance();
+        return *this;
+    }
+
+    bool operator==(EdgesIterator const& other) const
+    {
+        return current.index == other.current.index;
+    }
+
+    bool operator!=(EdgesIterator const& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    void advance()
+    {
+        auto const k = Direction::index(dir);
+        if (next[k] != EdgeIndex<Ix>::end()) {
+            set_current(next[k], k, false);
+            return;
+        }
+        if (!directed) {
+            auto const o = 1 - k;
+            while (next[o] != EdgeIndex<Ix>::end()) {
+                auto const& edge = edges->links(next[o].index());
+                if (edge.node[0] != edge.node[1]) {
+                    set_current(next[o], o, true);
+                    return;
+                }
+                next[o] = edge.next[o];
+            }
+        }
+        current.index = EdgeIndex<Ix>::end();
+    }
+
+    void set_current(EdgeIndex<Ix> e, std::size_t chain, bool swap)
+    {
+        auto const& edge = edges->links(e.index());
+        next[chain] = edge.next[chain];
+        current.index = e;
+        current.node = swap ? std::array<NodeIndex<Ix>, 2>{{edge.node[1], edge.node[0]}} : edge.node;
+        current.weight_ptr = &edges->weight(e.index());
+    }
+
+    Store const* edges;
+    Direction::Direction dir;
+    std::array<EdgeIndex<Ix>, 2> next;
+    EdgeReference<E, Ix> current;
+};
+
+/// Minimal begin/end pair so adjacency can be used in range-based for loops.
+template <typename It>
+struct IteratorRange
+{
+    It begin() const
+    {
+        return first;
+    }
+
+    It end() const
+    {
+        return last;
+    }
+
+    It first;
+    It last;
+};
+
+/// Old-to-new index maps returned by Graph::compact(). Removed nodes and
+/// edges map to `end()`.
+template <typename Ix>
+struct IndexRemap
+{
+    NodeIndex<Ix> node(NodeIndex<Ix> old) const
+    {
+        return nodes[old.index()];
+    }
+
+    EdgeIndex<Ix> edge(EdgeIndex<Ix> old) const
+    {
+        return old == EdgeIndex<Ix>::end() ? old : edges[old.index()];
+    }
+
+    std::vector<NodeIndex<Ix>> nodes;
+    std::vector<EdgeIndex<Ix>> edges;
+};
+
+/// Directed or undirected graph with petgraph-style intrusive adjacency:
+/// every node holds the head of its outgoing and ingoing edge chains and
+/// every edge the next link of both. `E = void` (or any empty type) stores no
+/// edge weights. `Storage` selects the edge layout, AosStorage or SoaStorage.
+///
+/// Removing a node or edge leaves a vacant slot behind instead of shifting
+/// later indices, so every other index stays valid. Vacant slots go on a free
+/// list and are reused by the next add_node/add_edge; compact() closes the
+/// remaining gaps and renumbers. node_count() and edge_count() count slots,
+/// vacant ones included, so they remain valid bounds for index-sized arrays.
+/// A vacant node has no edges, so searches see it as an isolated node.
+///
+/// `Alloc` is rebound for every vector the graph owns. With a stateful
+/// allocator such as ArenaAllocator, construct the graph from an allocator
+/// instance; copies and graphs built from it by the library use the same one.
+///
+/// Const member functions never write, so any number of threads may read one
+/// graph at the same time as long as none modifies it. Every algorithm takes
+/// its graph by const reference and keeps its state in caller-owned
+/// workspaces, one per thread.
+template <typename N, typename E_, bool directed, typename Ix, typename Storage, typename Alloc>
 struct Graph
 {
+    using E = edge_weight_type_t<E_>;
+    using node_weight_t = N;
+    using edge_weight_t = E;
+    using index_t = Ix;
+    using storage_t = Storage;
+    using allocator_type = Alloc;
+    using edge_store_t = typename Storage::template edge_store<E, Ix, Alloc>;
+    using edge_reference_t = EdgeReference<E, Ix>;
+    using edges_iterator_t = EdgesIterator<edge_store_t, directed>;
 
     Graph()
     : nodes()
@@ -149,28 +636,85 @@ struct Graph
     {
     }
 
-    Graph(std::size_t nodes, std::size_t edges)
-    : nodes(nodes)
-    , edges(edges)
+    explicit Graph(Alloc const& alloc)
+    : nodes(alloc)
+    , edges(alloc)
+    , vacant_nodes(alloc)
+    , free_nodes(alloc)
+    , free_edges(alloc)
+    {
+    }
+
+    /// Empty graph with room for `nodes` nodes and `edges` edges.
+    Graph(std::size_t nodes, std::size_t edges, Alloc const& alloc = Alloc())
+    : Graph(alloc)
     {
+        reserve_nodes(nodes);
+        reserve_edges(edges);
+    }
+
+    Alloc get_allocator() const
+    {
+        return Alloc(nodes.get_allocator());
+    }
+
+    void reserve_nodes(std::size_t additional)
+    {
+        nodes.reserve(nodes.size() + additional);
+    }
+
+    void reserve_edges(std::size_t additional)
+    {
+        edges.reserve(edges.size() + additional);
     }
 
     void clear()
     {
         nodes.clear();
         edges.clear();
+        vacant_nodes.clear();
+        free_nodes.clear();
+        free_edges.clear();
     }
 
+    /// Number of node slots: one past the highest node index ever handed out.
     std::size_t node_count() const
     {
         return nodes.size();
     }
 
+    /// Number of edge slots: one past the highest edge index ever handed out.
     std::size_t edge_count() const
     {
         return edges.size();
     }
 
+    std::size_t live_node_count() const
+    {
+        return nodes.size() - free_nodes.size();
+    }
+
+    std::size_t live_edge_count() const
+    {
+        return edges.size() - free_edges.size();
+    }
+
+    /// Whether any slot is vacant, i.e. whether compact() would renumber.
+    bool has_vacancies() const
+    {
+        return !free_nodes.empty() || !free_edges.empty();
+    }
+
+    bool contains_node(NodeIndex<Ix> a) const
+    {
+        return a.index() < nodes.size() && (a.index() >= vacant_nodes.size() || !vacant_nodes[a.index()]);
+    }
+
+    bool contains_edge(EdgeIndex<Ix> e) const
+    {
+        return e.index() < edges.size() && edges.links(e.index()).source() != NodeIndex<Ix>::end();
+    }
+
     bool is_directed() const
     {
         return directed;
@@ -178,6 +722,14 @@ struct Graph
 
     NodeIndex<Ix> add_node(N const& weight)
     {
+        if (!free_nodes.empty()) {
+            auto const reused = free_nodes.back();
+            free_nodes.pop_back();
+            nodes[reused.index()] = Node<N, Ix>(weight);
+            vacant_nodes[reused.index()] = false;
+            return reused;
+        }
+        assert(nodes.size() < std::numeric_limits<Ix>::max() && "node index space exhausted");
         auto const node_idx = NodeIndex<Ix>(nodes.size());
         nodes.push_back(Node<N, Ix>(weight));
         return node_idx;
@@ -193,43 +745,170 @@ struct Graph
         return nodes[a.index()].weight;
     }
 
-    auto add_edge(NodeIndex<Ix> a, NodeIndex<Ix> b, E const& weight) -> EdgeIndex<Ix>
+    auto add_edge(NodeIndex<Ix> a, NodeIndex<Ix> b, E const& weight = {}) -> EdgeIndex<Ix>
     {
-        auto const edge_idx = EdgeIndex<Ix>(edges.size());
+        auto const reuse = !free_edges.empty();
+        auto const edge_idx = reuse ? free_edges.back() : EdgeIndex<Ix>(edges.size());
         auto edge = Edge<E, Ix>({{a, b}}, weight);
 
+        assert(contains_node(a) && contains_node(b));
+        assert((reuse || edges.size() < std::numeric_limits<Ix>::max()) && "edge index space exhausted");
         if (a.index() == b.index()) {
-            auto& an = nodes.at(a.index());
+            auto& an = nodes[a.index()];
             edge.next = an.next;
             an.next[0] = an.next[1] = edge_idx;
         }
         else {
-            auto& an = nodes.at(a.index());
-            auto& bn = nodes.at(b.index());
+            auto& an = nodes[a.index()];
+            auto& bn = nodes[b.index()];
             edge.next = {{an.next[0], bn.next[1]}};
             an.next[0] = edge_idx;
             bn.next[1] = edge_idx;
         }
-        edges.push_back(edge);
+        if (reuse) {
+            free_edges.pop_back();
+            edges.links(edge_idx.index()) = edge;
+            edges.weight(edge_idx.index()) = weight;
+        }
+        else {
+            edges.push_back(edge);
+        }
         return edge_idx;
     }
 
+    /// Unlinks edge `e` from the outgoing chain of its source and the ingoing
+    /// chain of its target and frees its slot. Both chains are singly linked,
+    /// so this walks them: O(degree) of the two endpoints. Returns the weight.
+    E remove_edge(EdgeIndex<Ix> e)
+    {
+        assert(contains_edge(e));
+        auto& edge = edges.links(e.index());
+        for (std::size_t k = 0; k < 2; ++k) {
+            auto* link = &nodes[edge.node[k].index()].next[k];
+            while (*link != e) {
+                assert(*link != EdgeIndex<Ix>::end() && "edge missing from its chain");
+                link = &edges.links(link->index()).next[k];
+            }
+            *link = edge.next[k];
+        }
+        edge.next = {{EdgeIndex<Ix>::end(), EdgeIndex<Ix>::end()}};
+        edge.node = {{NodeIndex<Ix>::end(), NodeIndex<Ix>::end()}};
+        E weight = edges.weight(e.index());
+        free_edges.push_back(e);
+        return weight;
+    }
+
+    /// Removes every edge touching `a`, then frees its slot. Returns the
+    /// weight. Costs the degree of `a` plus that of each of its neighbours.
+    N remove_node(NodeIndex<Ix> a)
+    {
+        assert(contains_node(a));
+        for (std::size_t k = 0; k < 2; ++k) {
+            while (nodes[a.index()].next[k] != EdgeIndex<Ix>::end()) {
+                remove_edge(nodes[a.index()].next[k]);
+            }
+        }
+        vacant_nodes.resize(nodes.size(), false);
+        vacant_nodes[a.index()] = true;
+        free_nodes.push_back(a);
+        return nodes[a.index()].weight;
+    }
+
+    /// Moves live nodes and edges down over the vacant slots, keeping their
+    /// relative order and every chain's order, and empties the free lists.
+    /// Returns the map from old to new indices; all previously held indices
+    /// must be translated through it.
+    IndexRemap<Ix> compact()
+    {
+        IndexRemap<Ix> remap;
+        remap.nodes.resize(nodes.size(), NodeIndex<Ix>::end());
+        remap.edges.resize(edges.size(), EdgeIndex<Ix>::end());
+        std::size_t live = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (contains_node(NodeIndex<Ix>(static_cast<Ix>(i)))) {
+                remap.nodes[i] = NodeIndex<Ix>(static_cast<Ix>(live++));
+            }
+        }
+        live = 0;
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (contains_edge(EdgeIndex<Ix>(static_cast<Ix>(i)))) {
+                remap.edges[i] = EdgeIndex<Ix>(static_cast<Ix>(live++));
+            }
+        }
+
+        live = 0;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (remap.nodes[i] == NodeIndex<Ix>::end()) {
+                continue;
+            }
+            auto node = nodes[i];
+            node.next = {{remap.edge(node.next[0]), remap.edge(node.next[1])}};
+            nodes[live++] = node;
+        }
+        nodes.erase(nodes.begin() + static_cast<std::ptrdiff_t>(live), nodes.end());
+        live = 0;
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (remap.edges[i] == EdgeIndex<Ix>::end()) {
+                continue;
+            }
+            auto links = edges.links(i);
+            links.next = {{remap.edge(links.next[0]), remap.edge(links.next[1])}};
+            links.node = {{remap.node(links.node[0]), remap.node(links.node[1])}};
+            edges.links(live) = links;
+            edges.weight(live) = edges.weight(i);
+            ++live;
+        }
+        edges.truncate(live);
+
+        vacant_nodes.clear();
+        free_nodes.clear();
+        free_edges.clear();
+        return remap;
+    }
+
     E const& edge_weight(EdgeIndex<Ix> e) const
     {
-        return edges.at(e.index()).weight;
+        assert(e.index() < edges.size());
+        return edges.weight(e.index());
     }
 
     E& edge_weight(EdgeIndex<Ix> e)
     {
-        return edges.at(e.index()).weight;
+        assert(e.index() < edges.size());
+        return edges.weight(e.index());
     }
 
     std::pair<NodeIndex<Ix>, NodeIndex<Ix>> edge_endpoints(EdgeIndex<Ix> e) const
     {
-        auto const& ed = edges.at(e.index());
+        assert(e.index() < edges.size());
+        auto const& ed = edges.links(e.index());
         return std::make_pair(ed.source(), ed.target());
     }
 
-    std::vector<Node<N, Ix>> nodes;
-    std::vector<Edge<N, Ix>> edges;
+    /// Outgoing edges of `a`; for undirected graphs, every edge touching `a`.
+    IteratorRange<edges_iterator_t> edges_of(NodeIndex<Ix> a) const
+    {
+        return edges_directed(a, Direction::Direction::Outgoing);
+    }
+
+    IteratorRange<edges_iterator_t> edges_directed(NodeIndex<Ix> a, Direction::Direction dir) const
+    {
+        return {edges_iterator_t(&edges, nodes[a.index()].next, dir), edges_iterator_t()};
+    }
+
+    /// Number of edges `edges_directed(a, dir)` yields; walks the chain.
+    std::size_t degree(NodeIndex<Ix> a, Direction::Direction dir = Direction::Direction::Outgoing) const
+    {
+        auto const range = edges_directed(a, dir);
+        return static_cast<std::size_t>(std::distance(range.begin(), range.end()));
+    }
+
+    std::vector<Node<N, Ix>, rebind_alloc_t<Alloc, Node<N, Ix>>> nodes;
+    edge_store_t edges;
+    /// Vacancy flag per node slot, grown lazily by remove_node; slots past
+    /// its end are live.
+    std::vector<bool, rebind_alloc_t<Alloc, bool>> vacant_nodes;
+    /// Vacant slots, reused most recently freed first.
+    std::vector<NodeIndex<Ix>, rebind_alloc_t<Alloc, NodeIndex<Ix>>> free_nodes;
+    std::vector<EdgeIndex<Ix>, rebind_alloc_t<Alloc, EdgeIndex<Ix>>> free_edges;
 };
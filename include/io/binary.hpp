@@ -0,0 +1,344 @@
+#pragma once
+
+#include "graph.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// On-disk layout written by save_binary(). The `nodes` and `edges` vectors of
+/// the graph are stored verbatim, each section aligned to `section_alignment`
+/// bytes, so a mapped file can be used in place. Files are written in native
+/// byte order; `byte_order` lets a reader on another platform reject them.
+struct BinaryGraphHeader
+{
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t byte_order_mark = 0x01020304;
+    static constexpr std::size_t section_alignment = 64;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint8_t index_width;
+    std::uint8_t directed;
+    std::uint16_t reserved;
+    std::uint32_t node_size;
+    std::uint32_t edge_size;
+    std::uint32_t padding;
+    std::uint64_t node_count;
+    std::uint64_t edge_count;
+    std::uint64_t nodes_offset;
+    std::uint64_t edges_offset;
+    std::uint64_t file_size;
+    std::uint64_t payload_checksum;
+    std::uint64_t header_checksum;
+};
+
+namespace detail {
+
+inline char const* binary_graph_magic()
+{
+    return "MGLGRAPH";
+}
+
+/// Word-at-a-time 64-bit hash; fast enough to run over multi-gigabyte
+/// payloads at memory bandwidth.
+inline std::uint64_t checksum(void const* data, std::size_t size, std::uint64_t seed = 0x9e3779b97f4a7c15ull)
+{
+    auto const* bytes = static_cast<unsigned char const*>(data);
+    std::uint64_t hash = seed ^ (size * 0xff51afd7ed558ccdull);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash ^= word * 0xc4ceb9fe1a85ec53ull;
+        hash = (hash << 31) | (hash >> 33);
+        hash *= 0x9e3779b97f4a7c15ull;
+    }
+    for (; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline std::uint64_t align_up(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename N, typename E, bool directed, typename Ix>
+BinaryGraphHeader binary_header_for(std::size_t node_count, std::size_t edge_count)
+{
+    BinaryGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, binary_graph_magic(), sizeof(header.magic));
+    header.version = BinaryGraphHeader::current_version;
+    header.byte_order = BinaryGraphHeader::byte_order_mark;
+    header.index_width = sizeof(Ix);
+    header.directed = directed;
+    header.node_size = sizeof(Node<N, Ix>);
+    header.edge_size = sizeof(Edge<E, Ix>);
+    header.node_count = node_count;
+    header.edge_count = edge_count;
+    header.nodes_offset = align_up(sizeof(BinaryGraphHeader), BinaryGraphHeader::section_alignment);
+    header.edges_offset = align_up(header.nodes_offset + node_count * sizeof(Node<N, Ix>), BinaryGraphHeader::section_alignment);
+    header.file_size = header.edges_offset + edge_count * sizeof(Edge<E, Ix>);
+    return header;
+}
+
+}
+
+/// Writes `graph` to `path` in one sequential stream. Node and edge weights
+/// must be trivially copyable, and the graph must use the default AosStorage
+/// layout; any allocator works. Throws std::logic_error if the graph has
+/// vacancies, which compact() removes, and std::runtime_error on I/O failure.
+template <typename N, typename E_, bool directed, typename Ix, typename Alloc>
+void save_binary(Graph<N, E_, directed, Ix, AosStorage, Alloc> const& graph, std::string const& path)
+{
+    using E = edge_weight_type_t<E_>;
+    static_assert(std::is_trivially_copyable<Node<N, Ix>>::value, "node weights must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Edge<E, Ix>>::value, "edge weights must be trivially copyable");
+    if (graph.has_vacancies()) {
+        throw std::logic_error("compact() the graph before saving it");
+    }
+
+    auto header = detail::binary_header_for<N, E, directed, Ix>(graph.node_count(), graph.edge_count());
+    auto const node_bytes = graph.node_count() * sizeof(Node<N, Ix>);
+    auto const edge_bytes = graph.edge_count() * sizeof(Edge<E, Ix>);
+    header.payload_checksum = detail::checksum(graph.edges.data(), edge_bytes, detail::checksum(graph.nodes.data(), node_bytes));
+    header.header_checksum = detail::checksum(&header, offsetof(BinaryGraphHeader, header_checksum));
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("cannot open " + path + " for writing");
+    }
+    char const zeros[BinaryGraphHeader::section_alignment] = {};
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    out.write(zeros, header.nodes_offset - sizeof(header));
+    out.write(reinterpret_cast<char const*>(graph.nodes.data()), node_bytes);
+    out.write(zeros, header.edges_offset - header.nodes_offset - node_bytes);
+    out.write(reinterpret_cast<char const*>(graph.edges.data()), edge_bytes);
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("failed writing " + path);
+    }
+}
+
+/// Read-only view of a graph file written by save_binary(), mapped into
+/// memory with mmap. Opening validates the header and costs O(1) regardless
+/// of graph size; pages are faulted in as traversals touch them. It exposes
+/// the same read interface as Graph, so DFS, BFS and Dijkstra run on it
+/// directly. `E = void` works as in Graph. POSIX only.
+template <typename N, typename E_, bool directed, typename Ix>
+struct MappedGraph
+{
+    using E = edge_weight_type_t<E_>;
+    using node_weight_t = N;
+    using edge_weight_t = E;
+    using index_t = Ix;
+    using edge_reference_t = EdgeReference<E, Ix>;
+    using edges_iterator_t = EdgesIterator<EdgeArrayView<E, Ix>, directed>;
+
+    /// Maps `path`; throws std::runtime_error if the file is missing, not a
+    /// graph file, from another byte order or version, or was written for
+    /// different N, E, directedness or index width. With `verify` the payload
+    /// checksum is checked as well, which reads the whole file.
+    explicit MappedGraph(std::string const& path, bool verify = false)
+    : base(nullptr)
+    , size(0)
+    , node_data(nullptr)
+    , edge_data(nullptr)
+    , edge_view{nullptr, 0}
+    , header()
+    {
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(BinaryGraphHeader)) {
+            ::close(fd);
+            throw std::runtime_error(path + " is not a graph file");
+        }
+        size = static_cast<std::size_t>(st.st_size);
+        base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            throw std::runtime_error("cannot map " + path);
+        }
+
+        try {
+            validate(path);
+        }
+        catch (...) {
+            unmap();
+            throw;
+        }
+        if (verify && !verify_payload()) {
+            unmap();
+            throw std::runtime_error(path + " failed its payload checksum");
+        }
+    }
+
+    MappedGraph(MappedGraph&& other)
+    : base(other.base)
+    , size(other.size)
+    , node_data(other.node_data)
+    , edge_data(other.edge_data)
+    , edge_view(other.edge_view)
+    , header(other.header)
+    {
+        other.base = nullptr;
+        other.size = 0;
+    }
+
+    MappedGraph& operator=(MappedGraph&& other)
+    {
+        if (this != &other) {
+            unmap();
+            base = other.base;
+            size = other.size;
+            node_data = other.node_data;
+            edge_data = other.edge_data;
+            edge_view = other.edge_view;
+            header = other.header;
+            other.base = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    MappedGraph(MappedGraph const&) = delete;
+    MappedGraph& operator=(MappedGraph const&) = delete;
+
+    ~MappedGraph()
+    {
+        unmap();
+    }
+
+    /// Recomputes the payload checksum; O(file size).
+    bool verify_payload() const
+    {
+        auto const nodes_hash = detail::checksum(node_data, header.node_count * sizeof(Node<N, Ix>));
+        return detail::checksum(edge_data, header.edge_count * sizeof(Edge<E, Ix>), nodes_hash) == header.payload_checksum;
+    }
+
+    std::size_t node_count() const
+    {
+        return header.node_count;
+    }
+
+    std::size_t edge_count() const
+    {
+        return header.edge_count;
+    }
+
+    bool is_directed() const
+    {
+        return directed;
+    }
+
+    N const& node_weight(NodeIndex<Ix> a) const
+    {
+        return node_data[a.index()].weight;
+    }
+
+    E const& edge_weight(EdgeIndex<Ix> e) const
+    {
+        return edge_data[e.index()].weight;
+    }
+
+    std::pair<NodeIndex<Ix>, NodeIndex<Ix>> edge_endpoints(EdgeIndex<Ix> e) const
+    {
+        auto const& ed = edge_data[e.index()];
+        return std::make_pair(ed.source(), ed.target());
+    }
+
+    IteratorRange<edges_iterator_t> edges_of(NodeIndex<Ix> a) const
+    {
+        return edges_directed(a, Direction::Direction::Outgoing);
+    }
+
+    IteratorRange<edges_iterator_t> edges_directed(NodeIndex<Ix> a, Direction::Direction dir) const
+    {
+        return {edges_iterator_t(&edge_view, node_data[a.index()].next, dir), edges_iterator_t()};
+    }
+
+    std::size_t degree(NodeIndex<Ix> a, Direction::Direction dir = Direction::Direction::Outgoing) const
+    {
+        auto const range = edges_directed(a, dir);
+        return static_cast<std::size_t>(std::distance(range.begin(), range.end()));
+    }
+
+    /// Copies the mapped graph into a mutable Graph allocating through `alloc`.
+    template <typename Alloc = std::allocator<char>>
+    Graph<N, E_, directed, Ix, AosStorage, Alloc> to_graph(Alloc const& alloc = Alloc()) const
+    {
+        Graph<N, E_, directed, Ix, AosStorage, Alloc> graph(alloc);
+        graph.nodes.assign(node_data, node_data + header.node_count);
+        graph.edges.edges.assign(edge_data, edge_data + header.edge_count);
+        return graph;
+    }
+
+private:
+    void validate(std::string const& path)
+    {
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, detail::binary_graph_magic(), sizeof(header.magic)) != 0) {
+            throw std::runtime_error(path + " is not a graph file");
+        }
+        if (header.byte_order != BinaryGraphHeader::byte_order_mark) {
+            throw std::runtime_error(path + " was written with a different byte order");
+        }
+        if (header.header_checksum != detail::checksum(&header, offsetof(BinaryGraphHeader, header_checksum))) {
+            throw std::runtime_error(path + " has a corrupt header");
+        }
+        if (header.version != BinaryGraphHeader::current_version) {
+            throw std::runtime_error(path + " has unsupported version " + std::to_string(header.version));
+        }
+        auto const expected = detail::binary_header_for<N, E, directed, Ix>(header.node_count, header.edge_count);
+        if (header.index_width != expected.index_width || header.directed != expected.directed
+            || header.node_size != expected.node_size || header.edge_size != expected.edge_size) {
+            throw std::runtime_error(path + " was written for a different graph type");
+        }
+        if (header.nodes_offset != expected.nodes_offset || header.edges_offset != expected.edges_offset
+            || header.file_size != expected.file_size || size < header.file_size) {
+            throw std::runtime_error(path + " is truncated or malformed");
+        }
+        auto const* bytes = static_cast<char const*>(base);
+        node_data = reinterpret_cast<Node<N, Ix> const*>(bytes + header.nodes_offset);
+        edge_data = reinterpret_cast<Edge<E, Ix> const*>(bytes + header.edges_offset);
+        edge_view = EdgeArrayView<E, Ix>{edge_data, header.edge_count};
+    }
+
+    void unmap()
+    {
+        if (base != nullptr) {
+            ::munmap(base, size);
+            base = nullptr;
+        }
+    }
+
+    void* base;
+    std::size_t size;
+    Node<N, Ix> const* node_data;
+    Edge<E, Ix> const* edge_data;
+    EdgeArrayView<E, Ix> edge_view;
+    BinaryGraphHeader header;
+};
@@ -0,0 +1,404 @@
+#pragma once
+
+#include "builder.hpp"
+#include "graph.hpp"
+#include "parallel/thread_pool.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// How the text readers buffer and parse their input. The stream is consumed
+/// in blocks of `buffer_size` bytes, so memory beyond the graph itself stays
+/// bounded by a couple of blocks. With a pool of more than one thread each
+/// block is split at line boundaries and the pieces are parsed in parallel;
+/// edges keep their file order either way.
+struct TextReadOptions
+{
+    std::size_t buffer_size = std::size_t(1) << 22;
+    ThreadPool* pool = nullptr;
+};
+
+namespace detail {
+
+/// Per-format description of data lines: `u v [w]`, optionally preceded by a
+/// one-character tag, with ids counted from `base`.
+struct EdgeLineFormat
+{
+    char const* comment_prefixes;
+    char tag;
+    std::size_t base;
+    bool symmetric;
+};
+
+inline char const* skip_blanks(char const* p, char const* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+template <typename T>
+bool parse_token(char const*& p, char const* end, T& value)
+{
+    p = skip_blanks(p, end);
+    if constexpr (std::is_same<T, bool>::value) {
+        int raw = 0;
+        auto const result = std::from_chars(p, end, raw);
+        value = raw != 0;
+        p = result.ptr;
+        return result.ec == std::errc();
+    }
+    else {
+        auto const result = std::from_chars(p, end, value);
+        p = result.ptr;
+        return result.ec == std::errc();
+    }
+}
+
+[[noreturn]] inline void malformed_line(char const* first, char const* last, char const* what)
+{
+    auto const length = std::min<std::size_t>(last - first, 80);
+    throw std::runtime_error(std::string(what) + ": \"" + std::string(first, length) + "\"");
+}
+
+/// Parses the data lines in `[first, last)` and appends their edges, unlinked,
+/// to `out`, a vector or edge store of `Edge<E, Ix>`. `max_node` is raised to
+/// the largest endpoint seen.
+template <typename E, typename Ix, typename Out>
+void parse_edge_lines(char const* first, char const* last, EdgeLineFormat const& format, Out& out, std::size_t& max_node)
+{
+    while (first < last) {
+        auto const eol = static_cast<char const*>(std::memchr(first, '\n', last - first));
+        auto const line_end = eol ? eol : last;
+        auto p = skip_blanks(first, line_end);
+
+        if (p == line_end || std::strchr(format.comment_prefixes, *p) != nullptr) {
+            first = line_end + 1;
+            continue;
+        }
+        if (format.tag != '\0') {
+            if (*p != format.tag) {
+                malformed_line(first, line_end, "unexpected line");
+            }
+            ++p;
+        }
+
+        std::size_t u = 0;
+        std::size_t v = 0;
+        if (!parse_token(p, line_end, u) || !parse_token(p, line_end, v) || u < format.base || v < format.base) {
+            malformed_line(first, line_end, "malformed edge");
+        }
+        u -= format.base;
+        v -= format.base;
+        if (u >= std::numeric_limits<Ix>::max() || v >= std::numeric_limits<Ix>::max()) {
+            malformed_line(first, line_end, "node id does not fit the index type");
+        }
+
+        E weight = E();
+        if (skip_blanks(p, line_end) != line_end) {
+            if constexpr (std::is_arithmetic<E>::value) {
+                if (!parse_token(p, line_end, weight) || skip_blanks(p, line_end) != line_end) {
+                    malformed_line(first, line_end, "malformed weight");
+                }
+            }
+        }
+
+        max_node = std::max(max_node, std::max(u, v));
+        auto const a = NodeIndex<Ix>(static_cast<Ix>(u));
+        auto const b = NodeIndex<Ix>(static_cast<Ix>(v));
+        out.push_back(Edge<E, Ix>({{a, b}}, weight));
+        if (format.symmetric && u != v) {
+            out.push_back(Edge<E, Ix>({{b, a}}, weight));
+        }
+        first = line_end + 1;
+    }
+}
+
+/// What a format's header callback made of a line.
+enum class HeaderLine {
+    Consumed,
+    Last,
+    Data
+};
+
+/// Streams `in` block by block. Complete lines are first offered to
+/// `header(first, last)`, which may adjust `format` and `node_count`, until
+/// it reports the last header line or the first data line. The remaining
+/// lines are parsed as edges straight into `graph.edges`, and chains are
+/// linked once every edge is in place.
+template <typename G, typename Header>
+G read_edge_stream(std::istream& in, EdgeLineFormat& format, TextReadOptions const& options, Header&& header, std::size_t& node_count)
+{
+    using Ix = typename G::index_t;
+    using E = typename G::edge_weight_t;
+
+    G graph;
+    std::vector<char> buffer(std::max<std::size_t>(options.buffer_size, 256));
+    std::size_t carried = 0;
+    std::size_t max_node = 0;
+    bool in_header = true;
+    bool any_edge = false;
+
+    auto const threads = options.pool ? options.pool->size() : 1;
+    std::vector<std::vector<Edge<E, Ix>>> pieces(threads);
+    std::vector<std::size_t> piece_max(threads, 0);
+
+    while (true) {
+        in.read(buffer.data() + carried, buffer.size() - carried);
+        auto const got = static_cast<std::size_t>(in.gcount());
+        auto const filled = carried + got;
+        bool const at_end = got == 0 || !in;
+        if (filled == 0) {
+            break;
+        }
+
+        char const* begin = buffer.data();
+        char const* end = begin + filled;
+        char const* cut = end;
+        if (!at_end) {
+            while (cut > begin && cut[-1] != '\n') {
+                --cut;
+            }
+            if (cut == begin) {
+                // A single line longer than the buffer: grow and keep reading.
+                carried = filled;
+                buffer.resize(buffer.size() * 2);
+                continue;
+            }
+        }
+
+        while (in_header && begin < cut) {
+            auto const eol = static_cast<char const*>(std::memchr(begin, '\n', cut - begin));
+            auto const line_end = eol ? eol : cut;
+            auto const kind = header(begin, line_end);
+            if (kind == HeaderLine::Data) {
+                in_header = false;
+                break;
+            }
+            begin = line_end + 1 < cut ? line_end + 1 : cut;
+            in_header = kind == HeaderLine::Consumed;
+        }
+
+        if (!in_header && begin < cut) {
+            if (threads == 1) {
+                parse_edge_lines<E, Ix>(begin, cut, format, graph.edges, max_node);
+            }
+            else {
+                std::vector<char const*> bounds(threads + 1, cut);
+                bounds[0] = begin;
+                for (std::size_t t = 1; t < threads; ++t) {
+                    auto p = std::max(bounds[t - 1], begin + (cut - begin) * t / threads);
+                    while (p > begin && p < cut && p[-1] != '\n') {
+                        ++p;
+                    }
+                    bounds[t] = p;
+                }
+                std::vector<std::exception_ptr> errors(threads);
+                options.pool->run([&](std::size_t id) {
+                    pieces[id].clear();
+                    try {
+                        parse_edge_lines<E, Ix>(bounds[id], bounds[id + 1], format, pieces[id], piece_max[id]);
+                    }
+                    catch (...) {
+                        errors[id] = std::current_exception();
+                    }
+                });
+                for (auto const& error : errors) {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                }
+                for (std::size_t t = 0; t < threads; ++t) {
+                    graph.edges.reserve(graph.edges.size() + pieces[t].size());
+                    for (auto const& edge : pieces[t]) {
+                        graph.edges.push_back(edge);
+                    }
+                    max_node = std::max(max_node, piece_max[t]);
+                }
+            }
+            any_edge = any_edge || !graph.edges.empty();
+        }
+
+        carried = static_cast<std::size_t>(end - cut);
+        std::memmove(buffer.data(), cut, carried);
+        if (at_end) {
+            break;
+        }
+    }
+
+    if (any_edge) {
+        node_count = std::max(node_count, max_node + 1);
+    }
+    graph.nodes.resize(node_count);
+    if (options.pool) {
+        link_edges(graph, *options.pool);
+    }
+    else {
+        link_edges(graph);
+    }
+    return graph;
+}
+
+inline std::ifstream open_text(std::string const& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return in;
+}
+
+/// Parses `word` of the header line `[first, last)` as a whole count.
+inline std::size_t parse_count(std::string const& word, char const* first, char const* last, char const* what)
+{
+    std::size_t value = 0;
+    auto const end = word.data() + word.size();
+    auto const result = std::from_chars(word.data(), end, value);
+    if (result.ec != std::errc() || result.ptr != end) {
+        malformed_line(first, last, what);
+    }
+    return value;
+}
+
+/// Parses `word` like parse_count() as a node count, which must leave room
+/// in index type `Ix` as in from_edges().
+template <typename Ix>
+std::size_t parse_node_count(std::string const& word, char const* first, char const* last, char const* what)
+{
+    auto const value = parse_count(word, first, last, what);
+    if (value >= std::numeric_limits<Ix>::max()) {
+        malformed_line(first, last, "node count does not fit the index type");
+    }
+    return value;
+}
+
+inline std::vector<std::string> split_words(char const* first, char const* last)
+{
+    std::vector<std::string> words;
+    while (first < last) {
+        first = skip_blanks(first, last);
+        auto p = first;
+        while (p < last && *p != ' ' && *p != '\t' && *p != '\r') {
+            ++p;
+        }
+        if (p > first) {
+            words.emplace_back(first, p);
+        }
+        first = p;
+    }
+    return words;
+}
+
+}
+
+/// Reads a whitespace-separated edge list: one `source target [weight]` per
+/// line with 0-based node ids. Lines starting with `#` or `%` are comments.
+/// Missing weights default to `E()`.
+template <typename G>
+G read_edge_list(std::istream& in, TextReadOptions const& options = TextReadOptions())
+{
+    std::size_t node_count = 0;
+    auto format = detail::EdgeLineFormat{"#%", '\0', 0, false};
+    auto no_header = [](char const*, char const*) { return detail::HeaderLine::Data; };
+    return detail::read_edge_stream<G>(in, format, options, no_header, node_count);
+}
+
+/// Reads a DIMACS shortest-path `.gr` file: `c` comments, a `p sp n m`
+/// problem line and `a u v w` arcs with 1-based ids.
+template <typename G>
+G read_dimacs(std::istream& in, TextReadOptions const& options = TextReadOptions())
+{
+    std::size_t node_count = 0;
+    bool seen_problem = false;
+    auto format = detail::EdgeLineFormat{"c", 'a', 1, false};
+    auto header = [&](char const* first, char const* last) {
+        auto const p = detail::skip_blanks(first, last);
+        if (p == last || *p == 'c') {
+            return detail::HeaderLine::Consumed;
+        }
+        if (*p != 'p') {
+            if (!seen_problem) {
+                detail::malformed_line(first, last, "missing DIMACS problem line");
+            }
+            return detail::HeaderLine::Data;
+        }
+        auto const words = detail::split_words(p, last);
+        if (words.size() != 4 || words[1] != "sp") {
+            detail::malformed_line(first, last, "malformed DIMACS problem line");
+        }
+        node_count = detail::parse_node_count<typename G::index_t>(words[2], first, last, "malformed DIMACS problem line");
+        seen_problem = true;
+        return detail::HeaderLine::Consumed;
+    };
+    return detail::read_edge_stream<G>(in, format, options, header, node_count);
+}
+
+/// Reads a Matrix Market coordinate file as an adjacency matrix: entry
+/// `(i, j)` becomes an edge from node `i - 1` to node `j - 1`, and the node
+/// count is the larger matrix dimension. `pattern` matrices get `E()`
+/// weights. For `symmetric` matrices a directed graph also gets the mirrored
+/// edge; an undirected graph already covers both directions.
+template <typename G>
+G read_matrix_market(std::istream& in, TextReadOptions const& options = TextReadOptions())
+{
+    std::size_t node_count = 0;
+    bool seen_banner = false;
+    auto format = detail::EdgeLineFormat{"%", '\0', 1, false};
+    auto header = [&](char const* first, char const* last) {
+        auto const words = detail::split_words(first, last);
+        if (!seen_banner) {
+            if (words.size() != 5 || words[0] != "%%MatrixMarket" || words[1] != "matrix" || words[2] != "coordinate") {
+                detail::malformed_line(first, last, "not a Matrix Market coordinate file");
+            }
+            if (words[3] == "complex" || (words[4] != "general" && words[4] != "symmetric")) {
+                detail::malformed_line(first, last, "unsupported Matrix Market field or symmetry");
+            }
+            format.symmetric = words[4] == "symmetric" && G().is_directed();
+            seen_banner = true;
+            return detail::HeaderLine::Consumed;
+        }
+        if (words.empty() || words[0][0] == '%') {
+            return detail::HeaderLine::Consumed;
+        }
+        if (words.size() != 3) {
+            detail::malformed_line(first, last, "malformed Matrix Market size line");
+        }
+        auto const rows = detail::parse_node_count<typename G::index_t>(words[0], first, last, "malformed Matrix Market size line");
+        auto const columns = detail::parse_node_count<typename G::index_t>(words[1], first, last, "malformed Matrix Market size line");
+        detail::parse_count(words[2], first, last, "malformed Matrix Market size line");
+        node_count = std::max(rows, columns);
+        return detail::HeaderLine::Last;
+    };
+    return detail::read_edge_stream<G>(in, format, options, header, node_count);
+}
+
+template <typename G>
+G read_edge_list(std::string const& path, TextReadOptions const& options = TextReadOptions())
+{
+    auto in = detail::open_text(path);
+    return read_edge_list<G>(in, options);
+}
+
+template <typename G>
+G read_dimacs(std::string const& path, TextReadOptions const& options = TextReadOptions())
+{
+    auto in = detail::open_text(path);
+    return read_dimacs<G>(in, options);
+}
+
+template <typename G>
+G read_matrix_market(std::string const& path, TextReadOptions const& options = TextReadOptions())
+{
+    auto in = detail::open_text(path);
+    return read_matrix_market<G>(in, options);
+}
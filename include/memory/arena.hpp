@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// Monotonic bump allocator: memory is carved out of large chunks and never
+/// given back one block at a time. reset() makes all of it reusable at once
+/// and release() returns the chunks to the system, so everything built for
+/// one request (graphs, workspaces, results) is dropped in a single step
+/// instead of one free() per vector.
+///
+/// Not thread-safe: use one arena per thread. Anything allocated from an
+/// arena must be destroyed, or at least never touched again, before the
+/// arena is reset, released or destroyed.
+struct MonotonicArena
+{
+    explicit MonotonicArena(std::size_t chunk_size = 64 * 1024)
+    : first_chunk_size(std::max<std::size_t>(chunk_size, 64))
+    , current(0)
+    , offset(0)
+    , used(0)
+    {
+    }
+
+    MonotonicArena(MonotonicArena const&) = delete;
+    MonotonicArena& operator=(MonotonicArena const&) = delete;
+
+    ~MonotonicArena()
+    {
+        release();
+    }
+
+    /// `bytes` bytes aligned to `alignment`, a power of two. Chunks grow
+    /// geometrically, so a request allocates O(log size) times in total.
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+        while (current < chunks.size()) {
+            auto& chunk = chunks[current];
+            auto const base = reinterpret_cast<std::uintptr_t>(chunk.data);
+            auto const start = (base + offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+            if (start + bytes <= base + chunk.size) {
+                offset = start + bytes - base;
+                used += bytes;
+                return reinterpret_cast<void*>(start);
+            }
+            ++current;
+            offset = 0;
+        }
+        auto const last = chunks.empty() ? first_chunk_size / 2 : chunks.back().size;
+        auto const size = std::max(2 * last, bytes + alignment);
+        chunks.push_back(Chunk{static_cast<unsigned char*>(::operator new(size)), size});
+        current = chunks.size() - 1;
+        offset = 0;
+        return allocate(bytes, alignment);
+    }
+
+    /// Individual blocks are only reclaimed by reset() or release().
+    void deallocate(void*, std::size_t)
+    {
+    }
+
+    /// Makes every chunk available again without returning any of them, so
+    /// the next request of similar size does not allocate at all.
+    void reset()
+    {
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    /// Returns every chunk to the system.
+    void release()
+    {
+        for (auto const& chunk : chunks) {
+            ::operator delete(chunk.data);
+        }
+        chunks.clear();
+        reset();
+    }
+
+    /// Bytes handed out since the last reset or release.
+    std::size_t bytes_allocated() const
+    {
+        return used;
+    }
+
+    /// Bytes held from the system, in use or not.
+    std::size_t capacity() const
+    {
+        std::size_t total = 0;
+        for (auto const& chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk
+    {
+        unsigned char* data;
+        std::size_t size;
+    };
+
+    std::size_t first_chunk_size;
+    std::vector<Chunk> chunks;
+    std::size_t current;
+    std::size_t offset;
+    std::size_t used;
+};
+
+/// Standard allocator drawing from a MonotonicArena, for the `Alloc`
+/// parameter of Graph, SearchWorkspace, DijkstraResult and friends. Copies
+/// share the arena, and containers carry it along on copy, move and swap.
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(MonotonicArena& arena) noexcept
+    : arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) noexcept
+    : arena(other.arena)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        arena->deallocate(p, n * sizeof(T));
+    }
+
+    MonotonicArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b)
+{
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b)
+{
+    return !(a == b);
+}
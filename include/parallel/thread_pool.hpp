@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Fixed set of worker threads that run one job at a time. The calling thread
+/// takes part as worker 0, so a pool of size 1 runs everything inline and
+/// never starts a thread.
+struct ThreadPool
+{
+    explicit ThreadPool(std::size_t threads = default_size())
+    : job()
+    , generation(0)
+    , pending(0)
+    , stopping(false)
+    {
+        threads = std::max<std::size_t>(threads, 1);
+        workers.reserve(threads - 1);
+        for (std::size_t id = 1; id < threads; ++id) {
+            workers.emplace_back([this, id] { worker_loop(id); });
+        }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static std::size_t default_size()
+    {
+        return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+
+    std::size_t size() const
+    {
+        return workers.size() + 1;
+    }
+
+    /// Calls `fn(thread_id)` once on every worker, ids `[0, size())`, and
+    /// returns when all calls have finished. If calls throw, run() still
+    /// waits for every call and then rethrows the first exception.
+    void run(std::function<void(std::size_t)> const& fn)
+    {
+        if (workers.empty()) {
+            fn(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            pending = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        call(fn, 0);
+        std::exception_ptr first_error;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return pending == 0; });
+            job = nullptr;
+            first_error = std::exchange(error, nullptr);
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+    }
+
+    /// Splits `[begin, end)` into chunks of `grain` handed out dynamically and
+    /// calls `fn(first, last, thread_id)` for each chunk.
+    template <typename F>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F&& fn)
+    {
+        if (begin >= end) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        if (workers.empty() || end - begin <= grain) {
+            fn(begin, end, std::size_t(0));
+            return;
+        }
+        std::atomic<std::size_t> next(begin);
+        run([&](std::size_t id) {
+            while (true) {
+                auto const first = next.fetch_add(grain, std::memory_order_relaxed);
+                if (first >= end) {
+                    break;
+                }
+                fn(first, std::min(first + grain, end), id);
+            }
+        });
+    }
+
+    /// Work-stealing loop over `[begin, end)`. Every worker starts with an
+    /// equal contiguous share and runs it front to back in chunks of `grain`;
+    /// a worker that runs dry steals the back half of another worker's
+    /// remaining share. Calls `fn(first, last, thread_id)` for each chunk.
+    /// Suits items of very uneven cost, where parallel_for's single shared
+    /// counter would be contended or a static split would leave threads idle.
+    template <typename F>
+    void steal_for(std::size_t begin, std::size_t end, std::size_t grain, F&& fn)
+    {
+        if (begin >= end) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        if (workers.empty() || end - begin <= grain) {
+            fn(begin, end, std::size_t(0));
+            return;
+        }
+
+        struct alignas(64) Share
+        {
+            std::mutex lock;
+            std::size_t first = 0;
+            std::size_t last = 0;
+        };
+        auto const threads = size();
+        std::vector<Share> shares(threads);
+        for (std::size_t id = 0; id < threads; ++id) {
+            shares[id].first = begin + (end - begin) * id / threads;
+            shares[id].last = begin + (end - begin) * (id + 1) / threads;
+        }
+
+        run([&](std::size_t id) {
+            auto& own = shares[id];
+            while (true) {
+                std::size_t first = 0;
+                std::size_t last = 0;
+                {
+                    std::lock_guard<std::mutex> guard(own.lock);
+                    if (own.first < own.last) {
+                        first = own.first;
+                        last = std::min(first + grain, own.last);
+                        own.first = last;
+                    }
+                }
+                if (first < last) {
+                    fn(first, last, id);
+                    continue;
+                }
+
+                bool stole = false;
+                for (std::size_t k = 1; k < threads && !stole; ++k) {
+                    auto& victim = shares[(id + k) % threads];
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    if (victim.first < victim.last) {
+                        auto const mid = victim.first + (victim.last - victim.first) / 2;
+                        first = mid;
+                        last = victim.last;
+                        victim.last = mid;
+                        stole = true;
+                    }
+                }
+                if (!stole) {
+                    return;
+                }
+                std::lock_guard<std::mutex> guard(own.lock);
+                own.first = first;
+                own.last = last;
+            }
+        });
+    }
+
+private:
+    /// Runs one participant's call, keeping the first exception for run().
+    void call(std::function<void(std::size_t)> const& fn, std::size_t id)
+    {
+        try {
+            fn(id);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    void worker_loop(std::size_t id)
+    {
+        std::size_t seen = 0;
+        while (true) {
+            std::function<void(std::size_t)> const* current;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                current = job;
+            }
+            call(*current, id);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) {
+                    done.notify_one();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(std::size_t)> const* job;
+    std::exception_ptr error;
+    std::size_t generation;
+    std::size_t pending;
+    bool stopping;
+};
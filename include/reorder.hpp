@@ -0,0 +1,322 @@
+#pragma once
+
+#include "graph.hpp"
+#include "builder.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Node orderings reorder() can apply.
+enum class NodeOrder {
+    /// Reverse Cuthill-McKee: breadth-first from a peripheral node of each
+    /// component, neighbours by ascending degree, then reversed. Keeps the
+    /// index distance between neighbours (the bandwidth) small.
+    ReverseCuthillMcKee,
+    /// Plain breadth-first order from the smallest unvisited node.
+    BreadthFirst,
+    /// By descending degree, so the hubs that most traversals touch share
+    /// cache lines.
+    Degree,
+    /// Along a Hilbert curve through the node positions, for geometric
+    /// graphs such as road networks. Needs a position function.
+    Hilbert
+};
+
+/// Index translation returned by reorder(). Edge indices change as well.
+template <typename Ix>
+struct Reordering
+{
+    NodeIndex<Ix> to_new(NodeIndex<Ix> old) const
+    {
+        return old_to_new[old.index()];
+    }
+
+    NodeIndex<Ix> to_old(NodeIndex<Ix> v) const
+    {
+        return new_to_old[v.index()];
+    }
+
+    EdgeIndex<Ix> edge_to_new(EdgeIndex<Ix> old) const
+    {
+        return edge_old_to_new[old.index()];
+    }
+
+    std::vector<NodeIndex<Ix>> old_to_new;
+    std::vector<NodeIndex<Ix>> new_to_old;
+    std::vector<EdgeIndex<Ix>> edge_old_to_new;
+};
+
+namespace detail {
+
+/// Neighbours of `u` ignoring edge direction, each edge reported once per
+/// endpoint; self loops are skipped.
+template <typename G, typename F>
+void for_each_neighbor(G const& graph, NodeIndex<typename G::index_t> u, F&& fn)
+{
+    for (auto const& edge : graph.edges_directed(u, Direction::Direction::Outgoing)) {
+        if (edge.target() != u) {
+            fn(edge.target());
+        }
+    }
+    if (graph.is_directed()) {
+        for (auto const& edge : graph.edges_directed(u, Direction::Direction::Ingoing)) {
+            if (edge.source() != u) {
+                fn(edge.source());
+            }
+        }
+    }
+}
+
+/// Undirected degree of every node, as for_each_neighbor() counts it.
+template <typename G>
+std::vector<std::size_t> undirected_degrees(G const& graph)
+{
+    using Ix = typename G::index_t;
+
+    std::vector<std::size_t> degree(graph.node_count(), 0);
+    for (std::size_t u = 0; u < graph.node_count(); ++u) {
+        for_each_neighbor(graph, NodeIndex<Ix>(static_cast<Ix>(u)), [&](NodeIndex<Ix>) { ++degree[u]; });
+    }
+    return degree;
+}
+
+/// Breadth-first order over every component, ignoring edge direction. Each
+/// component starts from `root(first_unvisited)`, and when `by_degree` is set
+/// each node's unvisited neighbours are queued by ascending degree.
+template <typename G, typename Root>
+std::vector<NodeIndex<typename G::index_t>> breadth_first_order(G const& graph, std::vector<std::size_t> const& degree,
+                                                                bool by_degree, Root&& root)
+{
+    using Ix = typename G::index_t;
+
+    auto const n = graph.node_count();
+    std::vector<NodeIndex<Ix>> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    for (std::size_t s = 0; s < n; ++s) {
+        if (visited[s]) {
+            continue;
+        }
+        auto const start = root(NodeIndex<Ix>(static_cast<Ix>(s)), visited);
+        visited[start.index()] = true;
+        order.push_back(start);
+        for (auto head = order.size() - 1; head < order.size(); ++head) {
+            auto const first = order.size();
+            for_each_neighbor(graph, order[head], [&](NodeIndex<Ix> v) {
+                if (!visited[v.index()]) {
+                    visited[v.index()] = true;
+                    order.push_back(v);
+                }
+            });
+            if (by_degree) {
+                std::stable_sort(order.begin() + static_cast<std::ptrdiff_t>(first), order.end(),
+                                 [&](NodeIndex<Ix> a, NodeIndex<Ix> b) { return degree[a.index()] < degree[b.index()]; });
+            }
+        }
+    }
+    return order;
+}
+
+/// Index of the cell `(x, y)` along a Hilbert curve filling a 2^16 x 2^16
+/// grid.
+inline std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y)
+{
+    std::uint64_t d = 0;
+    for (std::uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        std::uint32_t const rx = (x & s) ? 1 : 0;
+        std::uint32_t const ry = (y & s) ? 1 : 0;
+        d += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+}
+
+/// The permutation `order` describes, with `order[i]` the old index of the
+/// node that becomes node `i`.
+template <typename G>
+std::vector<NodeIndex<typename G::index_t>> node_order(G const& graph, NodeOrder strategy)
+{
+    using Ix = typename G::index_t;
+    using Nx = NodeIndex<Ix>;
+
+    auto const n = graph.node_count();
+    auto const degree = detail::undirected_degrees(graph);
+    std::vector<Nx> order;
+
+    switch (strategy) {
+    case NodeOrder::BreadthFirst:
+        order = detail::breadth_first_order(graph, degree, false, [](Nx s, std::vector<bool> const&) { return s; });
+        break;
+    case NodeOrder::ReverseCuthillMcKee: {
+        // A pseudo-peripheral start: walk to the smallest-degree node of the
+        // last BFS level until the eccentricity stops growing.
+        std::vector<std::size_t> level(n, 0);
+        std::vector<Nx> queue;
+        auto const peripheral = [&](Nx s, std::vector<bool> const&) {
+            std::size_t depth = 0;
+            for (int round = 0; round < 8; ++round) {
+                queue.assign(1, s);
+                level[s.index()] = 1;
+                for (std::size_t head = 0; head < queue.size(); ++head) {
+                    auto const u = queue[head];
+                    detail::for_each_neighbor(graph, u, [&](Nx v) {
+                        if (level[v.index()] == 0) {
+                            level[v.index()] = level[u.index()] + 1;
+                            queue.push_back(v);
+                        }
+                    });
+                }
+                auto const last = level[queue.back().index()];
+                auto best = queue.back();
+                for (auto const v : queue) {
+                    if (level[v.index()] == last && degree[v.index()] < degree[best.index()]) {
+                        best = v;
+                    }
+                    level[v.index()] = 0;
+                }
+                if (last <= depth) {
+                    break;
+                }
+                depth = last;
+                s = best;
+            }
+            return s;
+        };
+        order = detail::breadth_first_order(graph, degree, true, peripheral);
+        std::reverse(order.begin(), order.end());
+        break;
+    }
+    case NodeOrder::Degree:
+        order.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            order[i] = Nx(static_cast<Ix>(i));
+        }
+        std::stable_sort(order.begin(), order.end(), [&](Nx a, Nx b) { return degree[a.index()] > degree[b.index()]; });
+        break;
+    case NodeOrder::Hilbert:
+        throw std::invalid_argument("Hilbert order needs node positions");
+    }
+    return order;
+}
+
+/// Hilbert order of the nodes, with `position(v)` returning the coordinates
+/// of node `v` as a pair of numbers. The bounding box of all positions is
+/// mapped onto a 2^16 x 2^16 grid; nodes in one cell keep their old order.
+template <typename G, typename P>
+std::vector<NodeIndex<typename G::index_t>> hilbert_order(G const& graph, P&& position)
+{
+    using Ix = typename G::index_t;
+    using Nx = NodeIndex<Ix>;
+
+    auto const n = graph.node_count();
+    std::vector<std::pair<double, double>> xy(n);
+    auto lo = std::make_pair(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    auto hi = std::make_pair(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const p = position(Nx(static_cast<Ix>(i)));
+        xy[i] = std::make_pair(static_cast<double>(p.first), static_cast<double>(p.second));
+        lo = std::make_pair(std::min(lo.first, xy[i].first), std::min(lo.second, xy[i].second));
+        hi = std::make_pair(std::max(hi.first, xy[i].first), std::max(hi.second, xy[i].second));
+    }
+    auto const cell = [](double v, double low, double high) {
+        auto const span = high - low;
+        return span > 0 ? static_cast<std::uint32_t>((v - low) / span * 65535.0) : 0u;
+    };
+    std::vector<std::pair<std::uint64_t, Nx>> keyed(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const d = detail::hilbert_index(cell(xy[i].first, lo.first, hi.first), cell(xy[i].second, lo.second, hi.second));
+        keyed[i] = std::make_pair(d, Nx(static_cast<Ix>(i)));
+    }
+    std::stable_sort(keyed.begin(), keyed.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+    std::vector<Nx> order(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        order[i] = keyed[i].second;
+    }
+    return order;
+}
+
+/// Rebuilds `graph` with node `order[i]` as node `i`. Edges are renumbered so
+/// that the edges of each source are contiguous and sorted by new source,
+/// then new target; chains are relinked as link_edges() would. Returns the
+/// translation of node and edge indices. Throws std::logic_error if `graph`
+/// has vacancies; compact() it first.
+template <typename G>
+Reordering<typename G::index_t> reorder(G& graph, std::vector<NodeIndex<typename G::index_t>> const& order)
+{
+    using Ix = typename G::index_t;
+    using Nx = NodeIndex<Ix>;
+    using E = typename G::edge_weight_t;
+
+    if (graph.has_vacancies()) {
+        throw std::logic_error("compact() the graph before reordering it");
+    }
+    assert(order.size() == graph.node_count());
+    auto const n = graph.node_count();
+    auto const m = graph.edge_count();
+
+    Reordering<Ix> result;
+    result.new_to_old = order;
+    result.old_to_new.assign(n, Nx::end());
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(result.old_to_new[order[i].index()] == Nx::end() && "order must be a permutation");
+        result.old_to_new[order[i].index()] = Nx(static_cast<Ix>(i));
+    }
+
+    std::vector<Ix> edge_order(m);
+    std::iota(edge_order.begin(), edge_order.end(), Ix(0));
+    auto const key = [&](Ix e) {
+        auto const& links = graph.edges.links(e);
+        return std::make_pair(result.to_new(links.source()).index(), result.to_new(links.target()).index());
+    };
+    std::stable_sort(edge_order.begin(), edge_order.end(), [&](Ix a, Ix b) { return key(a) < key(b); });
+
+    G rebuilt(graph.get_allocator());
+    rebuilt.nodes.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        rebuilt.nodes[i].weight = graph.nodes[order[i].index()].weight;
+    }
+    rebuilt.edges.reserve(m);
+    result.edge_old_to_new.assign(m, EdgeIndex<Ix>::end());
+    for (std::size_t i = 0; i < m; ++i) {
+        auto const e = edge_order[i];
+        auto const ends = key(e);
+        rebuilt.edges.push_back(Edge<E, Ix>({{Nx(static_cast<Ix>(ends.first)), Nx(static_cast<Ix>(ends.second))}},
+                                            graph.edges.weight(e)));
+        result.edge_old_to_new[e] = EdgeIndex<Ix>(static_cast<Ix>(i));
+    }
+    link_edges(rebuilt);
+    graph = std::move(rebuilt);
+    return result;
+}
+
+/// Computes the `strategy` order of `graph` and rebuilds it in that order.
+template <typename G>
+Reordering<typename G::index_t> reorder(G& graph, NodeOrder strategy)
+{
+    return reorder(graph, node_order(graph, strategy));
+}
+
+/// Same, with `position(v)` giving node coordinates for NodeOrder::Hilbert;
+/// other strategies ignore it.
+template <typename G, typename P>
+Reordering<typename G::index_t> reorder(G& graph, NodeOrder strategy, P&& position)
+{
+    if (strategy == NodeOrder::Hilbert) {
+        return reorder(graph, hilbert_order(graph, std::forward<P>(position)));
+    }
+    return reorder(graph, strategy);
+}
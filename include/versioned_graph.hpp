@@ -0,0 +1,449 @@
+#pragma once
+
+#include "graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Array split into fixed-size chunks held by shared pointers, so versions of
+/// it can share every chunk they did not modify. Reading is an extra
+/// indirection per access; the mutating members copy a chunk first unless
+/// this array is its only owner.
+template <typename T>
+struct ChunkedArray
+{
+    static constexpr std::size_t chunk_bits = 10;
+    static constexpr std::size_t chunk_size = std::size_t(1) << chunk_bits;
+
+    using chunk_t = std::vector<T>;
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    T const& operator[](std::size_t i) const
+    {
+        return (*chunks[i >> chunk_bits])[i & (chunk_size - 1)];
+    }
+
+    /// Element `i`, in a chunk owned by this array alone.
+    T& mutable_at(std::size_t i)
+    {
+        return (*own(i >> chunk_bits))[i & (chunk_size - 1)];
+    }
+
+    void push_back(T const& value)
+    {
+        if (count % chunk_size == 0) {
+            chunks.push_back(std::make_shared<chunk_t>());
+            chunks.back()->reserve(chunk_size);
+        }
+        own(chunks.size() - 1)->push_back(value);
+        ++count;
+    }
+
+    std::vector<std::shared_ptr<chunk_t>> chunks;
+    std::size_t count = 0;
+
+private:
+    std::shared_ptr<chunk_t>& own(std::size_t k)
+    {
+        auto& chunk = chunks[k];
+        if (chunk.use_count() != 1) {
+            auto copy = std::make_shared<chunk_t>();
+            copy->reserve(chunk_size);
+            copy->assign(chunk->begin(), chunk->end());
+            chunk = std::move(copy);
+        }
+        return chunk;
+    }
+};
+
+/// Edge store over a ChunkedArray of Edge records, for EdgesIterator.
+template <typename E, typename Ix>
+struct ChunkedEdgeStore
+{
+    using weight_t = E;
+    using index_t = Ix;
+
+    std::size_t size() const
+    {
+        return edges.size();
+    }
+
+    EdgeLinks<Ix> const& links(std::size_t i) const
+    {
+        return edges[i];
+    }
+
+    E const& weight(std::size_t i) const
+    {
+        return edges[i].weight;
+    }
+
+    ChunkedArray<Edge<E, Ix>> edges;
+};
+
+/// One immutable version of a VersionedGraph. It offers the read-only part
+/// of Graph's interface, so the traversals and searches that take any graph
+/// type run on it unchanged: breadth_first_search(), depth_first_search(),
+/// dijkstra(), shortest_paths(), bidirectional_dijkstra() and astar().
+/// Functions that take a concrete Graph, such as contract(), save_binary()
+/// and freeze(), or that mutate it, such as reorder(), do not accept it.
+template <typename N, typename E_, bool directed, typename Ix>
+struct GraphSnapshot
+{
+    using E = edge_weight_type_t<E_>;
+    using node_weight_t = N;
+    using edge_weight_t = E;
+    using index_t = Ix;
+    using edge_store_t = ChunkedEdgeStore<E, Ix>;
+    using edge_reference_t = EdgeReference<E, Ix>;
+    using edges_iterator_t = EdgesIterator<edge_store_t, directed>;
+
+    std::size_t node_count() const
+    {
+        return nodes.size();
+    }
+
+    std::size_t edge_count() const
+    {
+        return edges.size();
+    }
+
+    bool is_directed() const
+    {
+        return directed;
+    }
+
+    N const& node_weight(NodeIndex<Ix> a) const
+    {
+        return nodes[a.index()].weight;
+    }
+
+    E const& edge_weight(EdgeIndex<Ix> e) const
+    {
+        assert(e.index() < edges.size());
+        return edges.weight(e.index());
+    }
+
+    std::pair<NodeIndex<Ix>, NodeIndex<Ix>> edge_endpoints(EdgeIndex<Ix> e) const
+    {
+        assert(e.index() < edges.size());
+        auto const& ed = edges.links(e.index());
+        return std::make_pair(ed.source(), ed.target());
+    }
+
+    IteratorRange<edges_iterator_t> edges_of(NodeIndex<Ix> a) const
+    {
+        return edges_directed(a, Direction::Direction::Outgoing);
+    }
+
+    IteratorRange<edges_iterator_t> edges_directed(NodeIndex<Ix> a, Direction::Direction dir) const
+    {
+        return {edges_iterator_t(&edges, nodes[a.index()].next, dir), edges_iterator_t()};
+    }
+
+    std::size_t degree(NodeIndex<Ix> a, Direction::Direction dir = Direction::Direction::Outgoing) const
+    {
+        auto const range = edges_directed(a, dir);
+        return static_cast<std::size_t>(std::distance(range.begin(), range.end()));
+    }
+
+    ChunkedArray<Node<N, Ix>> nodes;
+    edge_store_t edges;
+    /// Number of publishes that led to this version; the empty graph is 0.
+    std::uint64_t version = 0;
+};
+
+/// Graph for one writer thread and any number of reader threads.
+///
+/// Readers pin the latest published snapshot and run queries on it while
+/// the writer keeps going: pinning stores an epoch in the reader's slot and
+/// loads one pointer, so readers never lock, never wait for the writer and
+/// never touch a reference count. The writer stages mutations in a private
+/// version and publish() makes the whole batch visible at once. Node and
+/// edge storage is chunked and copy-on-write, so a version shares every
+/// chunk the batch did not touch with the one before it; a batch costs its
+/// mutations plus one chunk copy per chunk they touch.
+///
+/// Replaced versions are freed once no reader pinned before their
+/// replacement is still pinned: every publish() and reclaim() checks the
+/// reader slots. A reader that stays pinned only delays reclamation.
+///
+/// add_node, add_edge, set_*_weight, pending, latest, publish and reclaim
+/// belong to the writer and must not be called concurrently with each other.
+/// reader() and everything on Reader and Pin are safe from any thread; each
+/// Reader is used by one thread at a time. Removal is not supported.
+template <typename N, typename E_ = char, bool directed = true, typename Ix = DefaultIx>
+struct VersionedGraph
+{
+    using snapshot_t = GraphSnapshot<N, E_, directed, Ix>;
+    using E = typename snapshot_t::E;
+    using index_t = Ix;
+
+    static constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+    /// Epoch of one reader; `idle` while unpinned. Padded so readers do not
+    /// share cache lines.
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch{idle};
+        std::atomic<bool> taken{false};
+    };
+
+    /// A pinned snapshot. It stays valid, and unchanged, until the Pin is
+    /// destroyed.
+    struct Pin
+    {
+        Pin(Slot* slot, snapshot_t const* snapshot)
+        : slot(slot)
+        , snapshot(snapshot)
+        {
+        }
+
+        Pin(Pin&& other) noexcept
+        : slot(std::exchange(other.slot, nullptr))
+        , snapshot(other.snapshot)
+        {
+        }
+
+        Pin(Pin const&) = delete;
+        Pin& operator=(Pin const&) = delete;
+        Pin& operator=(Pin&&) = delete;
+
+        ~Pin()
+        {
+            if (slot) {
+                slot->epoch.store(idle, std::memory_order_release);
+            }
+        }
+
+        snapshot_t const& operator*() const
+        {
+            return *snapshot;
+        }
+
+        snapshot_t const* operator->() const
+        {
+            return snapshot;
+        }
+
+        Slot* slot;
+        snapshot_t const* snapshot;
+    };
+
+    /// A registered reader, holding one slot until destroyed.
+    struct Reader
+    {
+        Reader(VersionedGraph const* owner, Slot* slot)
+        : owner(owner)
+        , slot(slot)
+        {
+        }
+
+        Reader(Reader&& other) noexcept
+        : owner(other.owner)
+        , slot(std::exchange(other.slot, nullptr))
+        {
+        }
+
+        Reader(Reader const&) = delete;
+        Reader& operator=(Reader const&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        ~Reader()
+        {
+            if (slot) {
+                assert(slot->epoch.load() == idle && "reader destroyed while pinned");
+                slot->taken.store(false, std::memory_order_release);
+            }
+        }
+
+        /// Pins the latest published snapshot. One pin per reader at a time.
+        Pin pin() const
+        {
+            assert(slot->epoch.load(std::memory_order_relaxed) == idle && "reader is already pinned");
+            slot->epoch.store(owner->epoch.load());
+            return Pin(slot, owner->current.load());
+        }
+
+        VersionedGraph const* owner;
+        Slot* slot;
+    };
+
+    /// Empty graph with room for `max_readers` registered readers.
+    explicit VersionedGraph(std::size_t max_readers = 64)
+    : slots(new Slot[max_readers])
+    , slot_count(max_readers)
+    , current(new snapshot_t())
+    , epoch(1)
+    {
+    }
+
+    /// Starts from a copy of `graph` as version 0. Throws std::logic_error if
+    /// `graph` has vacancies; compact() it first.
+    template <typename Storage, typename Alloc>
+    explicit VersionedGraph(Graph<N, E_, directed, Ix, Storage, Alloc> const& graph, std::size_t max_readers = 64)
+    : VersionedGraph(max_readers)
+    {
+        if (graph.has_vacancies()) {
+            throw std::logic_error("compact() the graph before versioning it");
+        }
+        auto* initial = current.load();
+        for (auto const& node : graph.nodes) {
+            initial->nodes.push_back(node);
+        }
+        for (std::size_t i = 0; i < graph.edge_count(); ++i) {
+            Edge<E, Ix> edge(graph.edges.links(i).node, graph.edges.weight(i));
+            edge.next = graph.edges.links(i).next;
+            initial->edges.edges.push_back(edge);
+        }
+    }
+
+    VersionedGraph(VersionedGraph const&) = delete;
+    VersionedGraph& operator=(VersionedGraph const&) = delete;
+
+    ~VersionedGraph()
+    {
+        for (std::size_t i = 0; i < slot_count; ++i) {
+            assert(!slots[i].taken.load() && "VersionedGraph destroyed with live readers");
+        }
+        for (auto const& entry : retired) {
+            delete entry.second;
+        }
+        delete current.load();
+    }
+
+    /// Registers a reader. Throws std::length_error when all `max_readers`
+    /// slots are taken.
+    Reader reader() const
+    {
+        for (std::size_t i = 0; i < slot_count; ++i) {
+            bool expected = false;
+            if (!slots[i].taken.load(std::memory_order_relaxed) && slots[i].taken.compare_exchange_strong(expected, true)) {
+                return Reader(this, &slots[i]);
+            }
+        }
+        throw std::length_error("VersionedGraph: no free reader slot");
+    }
+
+    /// The latest published version, as the writer sees it.
+    snapshot_t const& latest() const
+    {
+        return *current.load(std::memory_order_relaxed);
+    }
+
+    /// The version publish() would make visible, staged mutations included.
+    snapshot_t const& pending()
+    {
+        return staging();
+    }
+
+    bool has_pending() const
+    {
+        return working != nullptr;
+    }
+
+    NodeIndex<Ix> add_node(N const& weight)
+    {
+        auto& next = staging();
+        assert(next.nodes.size() < std::numeric_limits<Ix>::max() && "node index space exhausted");
+        auto const a = NodeIndex<Ix>(static_cast<Ix>(next.nodes.size()));
+        next.nodes.push_back(Node<N, Ix>(weight));
+        return a;
+    }
+
+    /// Adds an edge exactly as Graph::add_edge does, chain order included.
+    EdgeIndex<Ix> add_edge(NodeIndex<Ix> a, NodeIndex<Ix> b, E const& weight = {})
+    {
+        auto& next = staging();
+        assert(a.index() < next.nodes.size() && b.index() < next.nodes.size());
+        assert(next.edges.size() < std::numeric_limits<Ix>::max() && "edge index space exhausted");
+        auto const e = EdgeIndex<Ix>(static_cast<Ix>(next.edges.size()));
+        Edge<E, Ix> edge({{a, b}}, weight);
+        auto& an = next.nodes.mutable_at(a.index());
+        if (a == b) {
+            edge.next = an.next;
+            an.next[0] = an.next[1] = e;
+        }
+        else {
+            edge.next[0] = an.next[0];
+            an.next[0] = e;
+            auto& bn = next.nodes.mutable_at(b.index());
+            edge.next[1] = bn.next[1];
+            bn.next[1] = e;
+        }
+        next.edges.edges.push_back(edge);
+        return e;
+    }
+
+    void set_node_weight(NodeIndex<Ix> a, N const& weight)
+    {
+        staging().nodes.mutable_at(a.index()).weight = weight;
+    }
+
+    void set_edge_weight(EdgeIndex<Ix> e, E const& weight)
+    {
+        staging().edges.edges.mutable_at(e.index()).weight = weight;
+    }
+
+    /// Makes the staged mutations visible to readers that pin from now on
+    /// and returns the new version number. Without staged mutations, nothing
+    /// changes and the current number is returned.
+    std::uint64_t publish()
+    {
+        if (!working) {
+            return latest().version;
+        }
+        working->version = latest().version + 1;
+        auto const version = working->version;
+        auto* old = current.exchange(working.release());
+        auto const retired_at = epoch.fetch_add(1) + 1;
+        retired.emplace_back(retired_at, old);
+        reclaim();
+        return version;
+    }
+
+    /// Frees the replaced versions that no reader can still see and returns
+    /// how many are left waiting.
+    std::size_t reclaim()
+    {
+        auto oldest = idle;
+        for (std::size_t i = 0; i < slot_count; ++i) {
+            oldest = std::min(oldest, slots[i].epoch.load());
+        }
+        auto const keep = std::partition(retired.begin(), retired.end(), [oldest](auto const& entry) { return entry.first > oldest; });
+        for (auto it = keep; it != retired.end(); ++it) {
+            delete it->second;
+        }
+        retired.erase(keep, retired.end());
+        return retired.size();
+    }
+
+private:
+    snapshot_t& staging()
+    {
+        if (!working) {
+            working.reset(new snapshot_t(latest()));
+        }
+        return *working;
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slot_count;
+    std::atomic<snapshot_t*> current;
+    /// Bumped by every publish. A version retired at epoch `e` may still be
+    /// seen by readers pinned at an earlier epoch only.
+    std::atomic<std::uint64_t> epoch;
+    std::unique_ptr<snapshot_t> working;
+    std::vector<std::pair<std::uint64_t, snapshot_t*>> retired;
+};
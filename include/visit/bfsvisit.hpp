@@ -0,0 +1,241 @@
+#pragma once
+
+#include "declarations.hpp"
+#include "algorithms/search_stats.hpp"
+#include "algorithms/search_workspace.hpp"
+#include "parallel/thread_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/// Hop distances and BFS tree of a parallel breadth-first search, indexed by
+/// NodeIndex::index().
+template <typename Ix>
+struct BfsResult
+{
+    static Ix unreached()
+    {
+        return std::numeric_limits<Ix>::max();
+    }
+
+    bool reachable(NodeIndex<Ix> v) const
+    {
+        return depth[v.index()] != unreached();
+    }
+
+    std::vector<Ix> depth;
+    std::vector<NodeIndex<Ix>> parent;
+    std::size_t top_down_steps = 0;
+    std::size_t bottom_up_steps = 0;
+};
+
+/// Tuning knobs of the direction-optimizing search. The search switches to
+/// bottom-up when the edges leaving the frontier exceed `1 / alpha` of the
+/// edges not yet explored, and back to top-down once the frontier stops
+/// growing and holds fewer than `1 / beta` of the nodes.
+struct BfsOptions
+{
+    std::size_t alpha = 14;
+    std::size_t beta = 24;
+    std::size_t grain = 256;
+};
+
+/// Sequential breadth-first search from `start` into `ws`: hop counts go to
+/// `ws.distance` and the BFS tree to `ws.parent`/`ws.parent_edge`. Stops once
+/// `target` has been dequeued, if given. Does not allocate once `ws` has
+/// grown to the size of the graph. The work done is reported to `stats`, a
+/// stats policy such as SearchStats; a dequeued node counts as settled.
+template <typename G, typename W, typename A, typename S>
+void breadth_first_search(G const& graph, NodeIndex<typename G::index_t> start, SearchWorkspace<typename G::index_t, W, A>& ws,
+                          NodeIndex<typename G::index_t> target, S& stats)
+{
+    using Ix = typename G::index_t;
+    using Mark = typename SearchWorkspace<Ix, W, A>::Mark;
+
+    stats.begin(SearchKind::BreadthFirst);
+    ws.begin(graph.node_count());
+    ws.source = start;
+    ws.set_mark(start, Mark::Seen);
+    ws.distance[start.index()] = W();
+    ws.frontier.push_back(start);
+    stats.discover();
+
+    for (std::size_t head = 0; head < ws.frontier.size(); ++head) {
+        auto const u = ws.frontier[head];
+        stats.frontier(ws.frontier.size() - head);
+        stats.settle();
+        if (u == target) {
+            break;
+        }
+        auto const next = ws.distance[u.index()] + W(1);
+        for (auto const& edge : graph.edges_of(u)) {
+            auto const v = edge.target();
+            stats.relax();
+            if (ws.mark_of(v) != Mark::Unseen) {
+                continue;
+            }
+            ws.set_mark(v, Mark::Seen);
+            ws.distance[v.index()] = next;
+            ws.parent[v.index()] = u;
+            ws.parent_edge[v.index()] = edge.id();
+            ws.frontier.push_back(v);
+            stats.discover();
+        }
+    }
+    stats.end();
+}
+
+template <typename G, typename W, typename A>
+void breadth_first_search(G const& graph, NodeIndex<typename G::index_t> start, SearchWorkspace<typename G::index_t, W, A>& ws,
+                          NodeIndex<typename G::index_t> target = NodeIndex<typename G::index_t>::end())
+{
+    NoStats stats;
+    breadth_first_search(graph, start, ws, target, stats);
+}
+
+/// Direction-optimizing breadth-first search from `start`, run on `pool`.
+///
+/// Top-down steps expand a queue frontier over outgoing edges and claim nodes
+/// with an atomic fetch_or on the visited bitmap. Bottom-up steps give each
+/// thread a disjoint range of bitmap words and let every unvisited node in it
+/// look for a parent in the frontier bitmap over its ingoing edges, stopping
+/// at the first hit. Which parent wins a tie is unspecified; depths are
+/// always exact.
+template <typename G>
+BfsResult<typename G::index_t> breadth_first_search(G const& graph, NodeIndex<typename G::index_t> start, ThreadPool& pool,
+                                                    BfsOptions const& options = BfsOptions())
+{
+    using Ix = typename G::index_t;
+    using word_t = std::uint64_t;
+    constexpr std::size_t word_bits = 64;
+
+    auto const n = graph.node_count();
+    auto const words = (n + word_bits - 1) / word_bits;
+
+    BfsResult<Ix> result;
+    result.depth.assign(n, BfsResult<Ix>::unreached());
+    result.parent.assign(n, NodeIndex<Ix>::end());
+
+    std::vector<std::atomic<word_t>> visited(words);
+    for (auto& word : visited) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    std::vector<word_t> front_bits(words, 0);
+    std::vector<word_t> next_bits(words, 0);
+    std::vector<NodeIndex<Ix>> frontier;
+    std::vector<std::vector<NodeIndex<Ix>>> local(pool.size());
+
+    auto const bit = [](std::size_t i) { return word_t(1) << (i % word_bits); };
+
+    visited[start.index() / word_bits].fetch_or(bit(start.index()), std::memory_order_relaxed);
+    result.depth[start.index()] = 0;
+    frontier.push_back(start);
+
+    std::size_t edges_to_check = graph.is_directed() ? graph.edge_count() : 2 * graph.edge_count();
+    std::size_t scout = graph.degree(start);
+    std::size_t frontier_size = 1;
+    Ix level = 0;
+
+    auto top_down_step = [&]() -> std::size_t {
+        std::atomic<std::size_t> next_scout(0);
+        for (auto& queue : local) {
+            queue.clear();
+        }
+        pool.parallel_for(0, frontier.size(), options.grain, [&](std::size_t first, std::size_t last, std::size_t id) {
+            std::size_t chunk_scout = 0;
+            for (auto i = first; i < last; ++i) {
+                auto const u = frontier[i];
+                for (auto const& edge : graph.edges_of(u)) {
+                    auto const v = edge.target().index();
+                    auto& word = visited[v / word_bits];
+                    if (word.load(std::memory_order_relaxed) & bit(v)) {
+                        continue;
+                    }
+                    if (word.fetch_or(bit(v), std::memory_order_relaxed) & bit(v)) {
+                        continue;
+                    }
+                    result.depth[v] = level + 1;
+                    result.parent[v] = u;
+                    local[id].push_back(NodeIndex<Ix>(static_cast<Ix>(v)));
+                    chunk_scout += graph.degree(edge.target());
+                }
+            }
+            next_scout.fetch_add(chunk_scout, std::memory_order_relaxed);
+        });
+        frontier.clear();
+        for (auto const& queue : local) {
+            frontier.insert(frontier.end(), queue.begin(), queue.end());
+        }
+        return next_scout.load();
+    };
+
+    auto bottom_up_step = [&]() -> std::size_t {
+        std::atomic<std::size_t> awake(0);
+        auto const grain_words = options.grain / word_bits + 1;
+        pool.parallel_for(0, words, grain_words, [&](std::size_t first, std::size_t last, std::size_t) {
+            std::size_t chunk_awake = 0;
+            for (auto w = first; w < last; ++w) {
+                auto seen = visited[w].load(std::memory_order_relaxed);
+                word_t next = 0;
+                auto const end = std::min(n, (w + 1) * word_bits);
+                for (auto v = w * word_bits; v < end; ++v) {
+                    if (seen & bit(v)) {
+                        continue;
+                    }
+                    for (auto const& edge : graph.edges_directed(NodeIndex<Ix>(static_cast<Ix>(v)), Direction::Direction::Ingoing)) {
+                        auto const u = edge.source().index();
+                        if (front_bits[u / word_bits] & bit(u)) {
+                            result.depth[v] = level + 1;
+                            result.parent[v] = edge.source();
+                            seen |= bit(v);
+                            next |= bit(v);
+                            ++chunk_awake;
+                            break;
+                        }
+                    }
+                }
+                visited[w].store(seen, std::memory_order_relaxed);
+                next_bits[w] = next;
+            }
+            awake.fetch_add(chunk_awake, std::memory_order_relaxed);
+        });
+        return awake.load();
+    };
+
+    while (frontier_size > 0) {
+        if (scout > edges_to_check / options.alpha) {
+            std::fill(front_bits.begin(), front_bits.end(), 0);
+            for (auto const v : frontier) {
+                front_bits[v.index() / word_bits] |= bit(v.index());
+            }
+            std::size_t previous;
+            do {
+                previous = frontier_size;
+                frontier_size = bottom_up_step();
+                front_bits.swap(next_bits);
+                ++level;
+                ++result.bottom_up_steps;
+            } while (frontier_size > 0 && (frontier_size >= previous || frontier_size > n / options.beta));
+
+            frontier.clear();
+            scout = 0;
+            for (std::size_t w = 0; w < words; ++w) {
+                for (auto bits = front_bits[w]; bits != 0; bits &= bits - 1) {
+                    auto const v = NodeIndex<Ix>(static_cast<Ix>(w * word_bits + __builtin_ctzll(bits)));
+                    frontier.push_back(v);
+                    scout += graph.degree(v);
+                }
+            }
+        }
+        else {
+            edges_to_check -= std::min(scout, edges_to_check);
+            scout = top_down_step();
+            frontier_size = frontier.size();
+            ++level;
+            ++result.top_down_steps;
+        }
+    }
+    return result;
+}
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "declarations.hpp"
+#include "algorithms/search_stats.hpp"
+#include "algorithms/search_workspace.hpp"
 
 #include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+/// Event reported to a depth-first search visitor. Only the member named after
+/// `kind` is meaningful; times count discover and finish events together.
 template <typename N>
 struct DfsEvent {
 
@@ -15,36 +22,72 @@ struct DfsEvent {
         Finish,
     } kind;
 
-    union {
-        struct discover {
-            N source;
-            std::size_t time;
-        };
-        struct tree_edge {
-            N source;
-            N target;
-        };
-        struct back_edge {
-            N source;
-            N target;
-        };
-        struct cross_forward_edge {
-            N source;
-            N target;
-        };
-        struct finish {
-            N source;
-            std::size_t time;
-        };
+    struct NodeTime {
+        N source;
+        std::size_t time;
     };
 
+    struct NodePair {
+        N source;
+        N target;
+    };
+
+    NodeTime discover;
+    NodePair tree_edge;
+    NodePair back_edge;
+    NodePair cross_forward_edge;
+    NodeTime finish;
+
+    static DfsEvent Discover(N source, std::size_t time)
+    {
+        DfsEvent event;
+        event.kind = Kind::Discover;
+        event.discover = {source, time};
+        return event;
+    }
+
+    static DfsEvent TreeEdge(N source, N target)
+    {
+        DfsEvent event;
+        event.kind = Kind::TreeEdge;
+        event.tree_edge = {source, target};
+        return event;
+    }
+
+    static DfsEvent BackEdge(N source, N target)
+    {
+        DfsEvent event;
+        event.kind = Kind::BackEdge;
+        event.back_edge = {source, target};
+        return event;
+    }
+
+    static DfsEvent CrossForwardEdge(N source, N target)
+    {
+        DfsEvent event;
+        event.kind = Kind::CrossForwardEdge;
+        event.cross_forward_edge = {source, target};
+        return event;
+    }
+
+    static DfsEvent Finish(N source, std::size_t time)
+    {
+        DfsEvent event;
+        event.kind = Kind::Finish;
+        event.finish = {source, time};
+        return event;
+    }
 };
 
+/// Returned by visitors to steer a search. `Prune` on a Discover event skips
+/// the node's edges; on a TreeEdge event it leaves the target undiscovered.
+/// It is treated as `Continue` everywhere else.
 template <typename T>
 struct ControlFlow {
     enum class Kind {
         Continue,
-        Break
+        Break,
+        Prune
     } kind;
     T data;
 
@@ -52,43 +95,248 @@ struct ControlFlow {
     : kind(kind)
     , data(data)
     {}
+
+    static ControlFlow Continue()
+    {
+        return ControlFlow(Kind::Continue);
+    }
+
+    static ControlFlow Break(T const& data = {})
+    {
+        return ControlFlow(Kind::Break, data);
+    }
+
+    static ControlFlow Prune()
+    {
+        return ControlFlow(Kind::Prune);
+    }
+
+    bool should_break() const
+    {
+        return kind == Kind::Break;
+    }
+
+    bool should_prune() const
+    {
+        return kind == Kind::Prune;
+    }
 };
 
-template <typename N, typename E, bool directed, typename Ix, typename F>
-void depth_first_search(Graph<N, E, directed, Ix>& graph, NodeIndex<Ix> start, F&& visitor)
+/// Payload of the ControlFlow returned for visitors that return void.
+struct NoData {
+};
+
+namespace detail {
+
+template <typename F, typename Event>
+using raw_visitor_result_t = decltype(std::declval<F&>()(std::declval<Event const&>()));
+
+template <typename F, typename Event>
+using control_flow_t = typename std::conditional<std::is_void<raw_visitor_result_t<F, Event>>::value,
+                                                 ControlFlow<NoData>,
+                                                 raw_visitor_result_t<F, Event>>::type;
+
+template <typename C, typename F, typename Event>
+C call_visitor(F& visitor, Event const& event, std::true_type)
 {
-    std::size_t time = 0;
-    std::map<Ix, bool> discovered;
-    std::map<Ix, bool> finished;
-    dfs_visitor(graph, start, visitor, discovered, finished, time);
+    visitor(event);
+    return C::Continue();
 }
 
-#define TRY_CONTROL(expr) do {                           \
-auto TRY_CONTROL_RESULT = expr;                          \
-if (TRY_CONTROL_RESULT.kind == ControlFlow::Kind::Break) \
-    return TRY_CONTROL_RESULT;                           \
-} while (0);
+template <typename C, typename F, typename Event>
+C call_visitor(F& visitor, Event const& event, std::false_type)
+{
+    return visitor(event);
+}
 
-template <typename N, typename E, bool directed, typename Ix, typename F, typename T>
-ControlFlow<T> dfs_visitor(Graph<N, E, directed, Ix>& graph, NodeIndex<Ix> u, F&& visitor,
-                 std::map<Ix, bool>& discovered, std::map<Ix, bool>& finished, std::size_t& time)
+/// Calls `visitor`, mapping a void return to ControlFlow::Continue.
+template <typename F, typename Event>
+control_flow_t<F, Event> visit(F& visitor, Event const& event)
 {
-    if (!visit(discovered, u)) {
-        return ControlFlow(ControlFlow::Kind::Continue);
-    }
-    auto event = DfsEvent();
-    event.kind = DfsEvent::Kind::Discover;
-    event.discover.source = u;
-    event.discover.time = time++;
-    TRY_CONTROL(visitor(event));
+    return call_visitor<control_flow_t<F, Event>>(visitor, event, std::is_void<raw_visitor_result_t<F, Event>>());
 }
 
-template <typename Ix>
-bool visit(std::map<Ix, bool>& discovered_finished, NodeIndex<Ix> node)
+}
+
+/// One level of the explicit DFS stack: a gray node and its unscanned edges.
+template <typename G>
+struct DfsFrame {
+    NodeIndex<typename G::index_t> node;
+    typename G::edges_iterator_t next;
+    typename G::edges_iterator_t last;
+};
+
+/// Node marks plus the explicit stack DFS needs, so repeated searches reuse
+/// both. Node colors live in the marks: Unseen is white, Seen is gray and
+/// Done is black.
+template <typename G, typename Alloc = std::allocator<char>>
+struct DfsWorkspace : MarkWorkspace<typename G::index_t, Alloc> {
+    DfsWorkspace() = default;
+
+    explicit DfsWorkspace(Alloc const& alloc)
+    : MarkWorkspace<typename G::index_t, Alloc>(alloc)
+    , stack(alloc)
+    {
+    }
+
+    std::vector<DfsFrame<G>, rebind_alloc_t<Alloc, DfsFrame<G>>> stack;
+};
+
+namespace detail {
+
+template <typename G, typename It, typename F, typename A, typename S>
+control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, It first_start, It last_start, F& visitor, DfsWorkspace<G, A>& ws, S& stats)
 {
-    if (discovered_finished.find(node.index()) != discovered_finished.end()) {
-        discovered_finished[node.index()] = true;
-        return true;
+    using Ix = typename G::index_t;
+    using Event = DfsEvent<NodeIndex<Ix>>;
+    using Control = control_flow_t<F, Event>;
+    using Mark = typename MarkWorkspace<Ix, A>::Mark;
+
+    ws.begin(graph.node_count());
+    ws.stack.clear();
+    std::size_t time = 0;
+
+    // Discovers `u` and pushes its frame, unless the visitor breaks or
+    // prunes it; a pruned node is finished straight away.
+    auto discover = [&](NodeIndex<Ix> u, Control& control) {
+        ws.set_mark(u, Mark::Seen);
+        stats.discover();
+        control = visit(visitor, Event::Discover(u, time++));
+        if (control.should_break()) {
+            return;
+        }
+        if (control.should_prune()) {
+            ws.set_mark(u, Mark::Done);
+            stats.settle();
+            control = visit(visitor, Event::Finish(u, time++));
+            return;
+        }
+        auto const edges = graph.edges_of(u);
+        ws.stack.push_back(DfsFrame<G>{u, edges.begin(), edges.end()});
+        stats.frontier(ws.stack.size());
+    };
+
+    auto control = Control::Continue();
+    for (; first_start != last_start; ++first_start) {
+        auto const start = *first_start;
+        if (ws.mark_of(start) != Mark::Unseen) {
+            continue;
+        }
+        discover(start, control);
+        if (control.should_break()) {
+            return control;
+        }
+
+        while (!ws.stack.empty()) {
+            auto& frame = ws.stack.back();
+            auto const u = frame.node;
+
+            if (frame.next == frame.last) {
+                ws.stack.pop_back();
+                ws.set_mark(u, Mark::Done);
+                stats.settle();
+                control = visit(visitor, Event::Finish(u, time++));
+                if (control.should_break()) {
+                    return control;
+                }
+                continue;
+            }
+
+            auto const v = (*frame.next).target();
+            ++frame.next;
+            stats.relax();
+
+            switch (ws.mark_of(v)) {
+            case Mark::Unseen:
+                control = visit(visitor, Event::TreeEdge(u, v));
+                if (control.should_break()) {
+                    return control;
+                }
+                if (!control.should_prune()) {
+                    discover(v, control);
+                    if (control.should_break()) {
+                        return control;
+                    }
+                }
+                break;
+            case Mark::Seen:
+                control = visit(visitor, Event::BackEdge(u, v));
+                if (control.should_break()) {
+                    return control;
+                }
+                break;
+            case Mark::Done:
+                control = visit(visitor, Event::CrossForwardEdge(u, v));
+                if (control.should_break()) {
+                    return control;
+                }
+                break;
+            }
+        }
     }
-    return false;
+    return Control::Continue();
+}
+
+}
+
+/// Iterative depth-first search from each of `starts` in turn, skipping
+/// starts that an earlier one already reached. The visitor receives
+/// DfsEvent<NodeIndex<Ix>> and may return void or a ControlFlow; a Break is
+/// returned to the caller as soon as it is seen. Depth is bounded only by
+/// the memory available to `ws.stack`.
+///
+/// The work done is reported to `stats`, a stats policy such as SearchStats;
+/// a finished node counts as settled and the frontier is the stack.
+template <typename G, typename F, typename A, typename S>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, std::vector<NodeIndex<typename G::index_t>> const& starts, F&& visitor, DfsWorkspace<G, A>& ws,
+                   S& stats)
+{
+    stats.begin(SearchKind::DepthFirst);
+    auto const control = detail::depth_first_search(graph, starts.begin(), starts.end(), visitor, ws, stats);
+    stats.end();
+    return control;
+}
+
+template <typename G, typename F, typename A, typename S>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, NodeIndex<typename G::index_t> start, F&& visitor, DfsWorkspace<G, A>& ws, S& stats)
+{
+    stats.begin(SearchKind::DepthFirst);
+    auto const control = detail::depth_first_search(graph, &start, &start + 1, visitor, ws, stats);
+    stats.end();
+    return control;
+}
+
+template <typename G, typename F, typename A>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, std::vector<NodeIndex<typename G::index_t>> const& starts, F&& visitor, DfsWorkspace<G, A>& ws)
+{
+    NoStats stats;
+    return detail::depth_first_search(graph, starts.begin(), starts.end(), visitor, ws, stats);
+}
+
+template <typename G, typename F, typename A>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, NodeIndex<typename G::index_t> start, F&& visitor, DfsWorkspace<G, A>& ws)
+{
+    NoStats stats;
+    return detail::depth_first_search(graph, &start, &start + 1, visitor, ws, stats);
+}
+
+template <typename G, typename F>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, std::vector<NodeIndex<typename G::index_t>> const& starts, F&& visitor)
+{
+    DfsWorkspace<G> ws;
+    return depth_first_search(graph, starts, std::forward<F>(visitor), ws);
+}
+
+template <typename G, typename F>
+detail::control_flow_t<F, DfsEvent<NodeIndex<typename G::index_t>>>
+depth_first_search(G const& graph, NodeIndex<typename G::index_t> start, F&& visitor)
+{
+    DfsWorkspace<G> ws;
+    return depth_first_search(graph, start, std::forward<F>(visitor), ws);
 }
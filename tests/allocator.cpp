@@ -0,0 +1,241 @@
+#include "graph.hpp"
+#include "memory/arena.hpp"
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/point_to_point.hpp"
+#include "builder.hpp"
+#include "csr.hpp"
+#include "io/binary.hpp"
+#include "reorder.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <memory_resource>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Allocator that counts the bytes live through it in a shared counter.
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator(std::ptrdiff_t& live)
+    : live(&live)
+    {
+    }
+
+    template <typename U>
+    CountingAllocator(CountingAllocator<U> const& other)
+    : live(other.live)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        *live += static_cast<std::ptrdiff_t>(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        *live -= static_cast<std::ptrdiff_t>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    std::ptrdiff_t* live;
+};
+
+template <typename T, typename U>
+bool operator==(CountingAllocator<T> const& a, CountingAllocator<U> const& b)
+{
+    return a.live == b.live;
+}
+
+template <typename T, typename U>
+bool operator!=(CountingAllocator<T> const& a, CountingAllocator<U> const& b)
+{
+    return !(a == b);
+}
+
+std::vector<std::tuple<int, int, int>> random_edges(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> node(0, 199);
+    std::uniform_int_distribution<int> cost(1, 30);
+    std::vector<std::tuple<int, int, int>> edge_list;
+    for (int i = 0; i < 1200; ++i) {
+        edge_list.emplace_back(node(rng), node(rng), cost(rng));
+    }
+    return edge_list;
+}
+
+template <typename G>
+int edge_weight(typename G::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+}
+
+SCENARIO("Graphs and search state with a custom allocator", "[allocator]")
+{
+
+    auto const edge_list = random_edges(17);
+    auto const plain = from_edges<DiGraph<int, int>>(edge_list, 200);
+    auto const expected = dijkstra(plain, NodeIndex<DefaultIx>(0), edge_weight<DiGraph<int, int>>);
+
+    GIVEN("A counting allocator")
+    {
+
+        using Alloc = CountingAllocator<char>;
+        std::ptrdiff_t live = 0;
+
+        THEN("All graph and search storage goes through it and is returned")
+        {
+            {
+                using G = DiGraph<int, int, DefaultIx, SoaStorage, Alloc>;
+                auto graph = from_edges<G>(edge_list, 200, Alloc(live));
+                auto const after_build = live;
+                REQUIRE(after_build >= std::ptrdiff_t(200 * sizeof(Node<int, DefaultIx>) + 1200 * sizeof(EdgeLinks<DefaultIx>)));
+
+                DijkstraResult<DefaultIx, int, Alloc> result{Alloc(live)};
+                dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight<G>, result);
+                REQUIRE(live > after_build);
+                REQUIRE(result.distance == decltype(result.distance)(expected.distance.begin(), expected.distance.end(), Alloc(live)));
+
+                graph.remove_node(NodeIndex<DefaultIx>(3));
+                graph.compact();
+                auto copy = graph;
+                REQUIRE(copy.get_allocator() == Alloc(live));
+            }
+            REQUIRE(live == 0);
+        }
+    }
+
+    GIVEN("A monotonic arena")
+    {
+
+        MonotonicArena arena(1024);
+        using Alloc = ArenaAllocator<char>;
+        using G = DiGraph<int, int, DefaultIx, AosStorage, Alloc>;
+
+        THEN("Graphs, workspaces and results built from it behave like the default ones")
+        {
+            G graph{Alloc(arena)};
+            for (int i = 0; i < 200; ++i) {
+                graph.add_node(i);
+            }
+            for (auto const& e : edge_list) {
+                graph.add_edge(NodeIndex<DefaultIx>(std::get<0>(e)), NodeIndex<DefaultIx>(std::get<1>(e)), std::get<2>(e));
+            }
+            REQUIRE(arena.bytes_allocated() > 0);
+
+            SearchWorkspace<DefaultIx, int, Alloc> ws{Alloc(arena)};
+            dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight<G>, ws);
+            for (std::size_t v = 0; v < 200; ++v) {
+                REQUIRE(ws.distance_to(NodeIndex<DefaultIx>(v)) == expected.distance[v]);
+            }
+
+            SearchWorkspace<DefaultIx, double, Alloc> hops{Alloc(arena)};
+            SearchWorkspace<DefaultIx> plain_hops;
+            breadth_first_search(graph, NodeIndex<DefaultIx>(0), hops);
+            breadth_first_search(plain, NodeIndex<DefaultIx>(0), plain_hops);
+            for (std::size_t v = 0; v < 200; ++v) {
+                REQUIRE(hops.distance_to(NodeIndex<DefaultIx>(v)) == plain_hops.distance_to(NodeIndex<DefaultIx>(v)));
+            }
+
+            DfsWorkspace<G, Alloc> dfs{Alloc(arena)};
+            std::size_t discovered = 0;
+            depth_first_search(graph, NodeIndex<DefaultIx>(0), [&](DfsEvent<NodeIndex<DefaultIx>> const& event) {
+                discovered += event.kind == DfsEvent<NodeIndex<DefaultIx>>::Kind::Discover;
+            }, dfs);
+            REQUIRE(discovered > 1);
+
+            SearchWorkspace<DefaultIx, int, Alloc> astar_ws{Alloc(arena)};
+            BidirectionalWorkspace<DefaultIx, int, Alloc> bidirectional_ws{Alloc(arena)};
+            auto const ch = contract(graph, edge_weight<G>);
+            ChQueryWorkspace<DefaultIx, std::int64_t, Alloc> ch_ws{Alloc(arena)};
+            for (std::size_t v = 0; v < 200; v += 7) {
+                auto const target = NodeIndex<DefaultIx>(v);
+                auto const zero = [](NodeIndex<DefaultIx>) { return 0; };
+                auto const path = astar(graph, NodeIndex<DefaultIx>(0), target, edge_weight<G>, zero, astar_ws);
+                REQUIRE(path.found() == expected.reachable(target));
+                if (path.found()) {
+                    REQUIRE(path.distance == expected.distance[v]);
+                    REQUIRE(path.nodes.back() == target);
+                    REQUIRE(bidirectional_dijkstra(graph, NodeIndex<DefaultIx>(0), target, edge_weight<G>, bidirectional_ws).distance == path.distance);
+                    REQUIRE(ch.query(NodeIndex<DefaultIx>(0), target, ch_ws).distance == path.distance);
+                }
+            }
+
+            std::string const path = "allocator_roundtrip_test.bin";
+            save_binary(graph, path);
+            {
+                MappedGraph<int, int, true, DefaultIx> mapped(path);
+                auto const copy = mapped.to_graph(Alloc(arena));
+                REQUIRE(copy.get_allocator() == Alloc(arena));
+                REQUIRE(copy.edge_count() == graph.edge_count());
+            }
+            std::remove(path.c_str());
+
+            auto const map = reorder(graph, NodeOrder::ReverseCuthillMcKee);
+            REQUIRE(graph.get_allocator() == Alloc(arena));
+            REQUIRE(freeze(graph).edge_count() == plain.edge_count());
+            auto const reordered = dijkstra(graph, map.to_new(NodeIndex<DefaultIx>(0)), edge_weight<G>);
+            for (std::size_t v = 0; v < 200; ++v) {
+                REQUIRE(reordered.distance[map.to_new(NodeIndex<DefaultIx>(v)).index()] == expected.distance[v]);
+            }
+        }
+
+        THEN("reset() reuses the chunks and release() returns them")
+        {
+            {
+                G graph = from_edges<G>(edge_list, 200, Alloc(arena));
+                REQUIRE(graph.edge_count() == 1200);
+            }
+            auto const held = arena.capacity();
+            REQUIRE(held >= arena.bytes_allocated());
+            arena.reset();
+            REQUIRE(arena.bytes_allocated() == 0);
+            {
+                G graph = from_edges<G>(edge_list, 200, Alloc(arena));
+                REQUIRE(graph.edge_count() == 1200);
+            }
+            REQUIRE(arena.capacity() == held);
+            arena.release();
+            REQUIRE(arena.capacity() == 0);
+        }
+
+        THEN("Blocks honour their alignment")
+        {
+            for (std::size_t align : {1, 2, 8, 16, 64, 256}) {
+                auto const* p = arena.allocate(3, align);
+                REQUIRE(reinterpret_cast<std::uintptr_t>(p) % align == 0);
+            }
+        }
+    }
+
+    GIVEN("A standard polymorphic memory resource")
+    {
+
+        std::pmr::monotonic_buffer_resource resource;
+        using Alloc = std::pmr::polymorphic_allocator<char>;
+        using G = UnGraph<int, int, DefaultIx, SoaStorage, Alloc>;
+
+        THEN("It works as the allocator parameter as well")
+        {
+            auto graph = from_edges<G>(edge_list, 200, Alloc(&resource));
+            REQUIRE(graph.get_allocator().resource() == &resource);
+            SearchWorkspace<DefaultIx, int, Alloc> ws{Alloc(&resource)};
+            dijkstra(graph, NodeIndex<DefaultIx>(0), edge_weight<G>, ws);
+            REQUIRE(ws.distance_to(NodeIndex<DefaultIx>(0)) == 0);
+            REQUIRE(ws.reachable(NodeIndex<DefaultIx>(std::get<1>(edge_list[0]))));
+        }
+    }
+}
@@ -1,6 +1,35 @@
 #include "graph.hpp"
+#include "builder.hpp"
 #include <catch.hpp>
 #include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+template <typename G>
+bool same_structure(G const& lhs, G const& rhs)
+{
+    if (lhs.node_count() != rhs.node_count() || lhs.edge_count() != rhs.edge_count()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.node_count(); ++i) {
+        if (lhs.nodes[i].next != rhs.nodes[i].next) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < lhs.edge_count(); ++i) {
+        auto const& a = lhs.edges.links(i);
+        auto const& b = rhs.edges.links(i);
+        if (a.node != b.node || a.next != b.next || lhs.edges.weight(i) != rhs.edges.weight(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
 
 SCENARIO("Basic Operations", "[basic-operations]")
 {
@@ -71,4 +100,55 @@ SCENARIO("Basic Operations", "[basic-operations]")
         }
 
     }
+
+    GIVEN("An edge list with self loops and parallel edges")
+    {
+
+        const int num_vertices = 300;
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<DefaultIx> pick(0, num_vertices - 1);
+        std::vector<std::tuple<DefaultIx, DefaultIx, int>> edge_list;
+
+        for (int i = 0; i < 5000; ++i) {
+            edge_list.push_back(std::make_tuple(pick(rng), pick(rng), i));
+        }
+        edge_list.push_back(std::make_tuple(DefaultIx(7), DefaultIx(7), -1));
+        edge_list.push_back(std::make_tuple(DefaultIx(7), DefaultIx(7), -2));
+
+        DiGraph<int, int> incremental(num_vertices + 10, edge_list.size());
+        for (int i = 0; i < num_vertices + 10; ++i) {
+            incremental.add_node(0);
+        }
+        for (auto const& e : edge_list) {
+            incremental.add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        }
+
+        WHEN("The graph is built in bulk")
+        {
+
+            auto const sequential = from_edges<DiGraph<int, int>>(edge_list, num_vertices + 10);
+            ThreadPool pool(3);
+            auto const parallel = from_edges<DiGraph<int, int>>(edge_list, num_vertices + 10, pool);
+
+            THEN("It is identical to the incrementally built graph")
+            {
+                REQUIRE(same_structure(sequential, incremental));
+                REQUIRE(same_structure(parallel, incremental));
+            }
+        }
+
+        WHEN("No node count is given")
+        {
+
+            std::vector<std::pair<DefaultIx, DefaultIx>> pairs = {{0, 4}, {4, 2}};
+            auto const graph = from_edges<UnGraph<int, int>>(pairs);
+
+            THEN("Nodes are created up to the highest endpoint")
+            {
+                REQUIRE(graph.node_count() == 5);
+                REQUIRE(graph.edge_count() == 2);
+                REQUIRE(graph.degree(NodeIndex<DefaultIx>(4)) == 2);
+            }
+        }
+    }
 }
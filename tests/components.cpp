@@ -0,0 +1,194 @@
+#include "graph.hpp"
+#include "algorithms/components.hpp"
+#include "builder.hpp"
+#include "csr.hpp"
+#include <catch.hpp>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Whether `a` and `b` group the nodes the same way, whatever their ids.
+template <typename Ix>
+bool same_partition(ComponentMap<Ix> const& a, ComponentMap<Ix> const& b)
+{
+    if (a.count != b.count || a.component_id.size() != b.component_id.size()) {
+        return false;
+    }
+    std::map<Ix, Ix> a_to_b;
+    for (std::size_t i = 0; i < a.component_id.size(); ++i) {
+        auto const inserted = a_to_b.emplace(a.component_id[i], b.component_id[i]);
+        if (inserted.first->second != b.component_id[i]) {
+            return false;
+        }
+    }
+    return a_to_b.size() == a.count;
+}
+
+/// Nodes reachable from `start`, by plain sequential search.
+template <typename G>
+std::vector<bool> reachable_from(G const& graph, std::size_t start, Direction::Direction dir)
+{
+    std::vector<bool> seen(graph.node_count(), false);
+    std::vector<std::size_t> stack{start};
+    seen[start] = true;
+    while (!stack.empty()) {
+        auto const u = stack.back();
+        stack.pop_back();
+        for (auto const& edge : graph.edges_directed(NodeIndex<DefaultIx>(u), dir)) {
+            auto const v = dir == Direction::Direction::Outgoing ? edge.target().index() : edge.source().index();
+            if (!seen[v]) {
+                seen[v] = true;
+                stack.push_back(v);
+            }
+        }
+    }
+    return seen;
+}
+
+}
+
+SCENARIO("Connected components", "[components]")
+{
+
+    GIVEN("An undirected graph with three components and an isolated node")
+    {
+
+        std::vector<std::pair<int, int>> edge_list{{0, 1}, {1, 2}, {3, 4}, {5, 6}, {6, 7}, {7, 5}};
+        auto const graph = from_edges<UnGraph<int, int>>(edge_list, 9);
+
+        THEN("Ids are dense and numbered by smallest node")
+        {
+            auto const components = connected_components(graph);
+            REQUIRE(components.count == 4);
+            REQUIRE(components.component_id == (std::vector<DefaultIx>{0, 0, 0, 1, 1, 2, 2, 2, 3}));
+        }
+    }
+
+    GIVEN("A large random undirected graph")
+    {
+
+        std::mt19937 rng(4);
+        std::uniform_int_distribution<int> node(0, 19999);
+        std::vector<std::pair<int, int>> edge_list;
+        for (int i = 0; i < 15000; ++i) {
+            edge_list.emplace_back(node(rng), node(rng));
+        }
+        auto const graph = from_edges<UnGraph<int, int>>(edge_list, 20000);
+
+        THEN("Every thread count gives the same ids, and edges stay inside components")
+        {
+            auto const sequential = connected_components(graph);
+            for (std::size_t threads : {2, 4}) {
+                ThreadPool pool(threads);
+                auto const parallel = connected_components(graph, pool, 64);
+                REQUIRE(parallel.component_id == sequential.component_id);
+                REQUIRE(connected_components(freeze(graph), pool, 64).component_id == sequential.component_id);
+            }
+            for (auto const& e : edge_list) {
+                REQUIRE(sequential.component_id[e.first] == sequential.component_id[e.second]);
+            }
+            for (std::size_t start : {0, 77, 1234}) {
+                auto const seen = reachable_from(graph, start, Direction::Direction::Outgoing);
+                for (std::size_t v = 0; v < graph.node_count(); ++v) {
+                    REQUIRE(seen[v] == (sequential.component_id[v] == sequential.component_id[start]));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Strongly connected components", "[components]")
+{
+
+    GIVEN("Two cycles joined by an edge, with a tail")
+    {
+
+        std::vector<std::pair<int, int>> edge_list{{0, 1}, {1, 2}, {2, 0}, {2, 3}, {3, 4}, {4, 3}, {4, 5}};
+        auto const graph = from_edges<DiGraph<int, int>>(edge_list);
+
+        THEN("Tarjan numbers the components sinks first")
+        {
+            auto const components = strongly_connected_components(graph);
+            REQUIRE(components.count == 3);
+            REQUIRE(components.component_id == (std::vector<DefaultIx>{2, 2, 2, 1, 1, 0}));
+        }
+
+        THEN("The parallel variant finds the same partition")
+        {
+            ThreadPool pool(3);
+            auto const components = strongly_connected_components(graph, pool);
+            REQUIRE(components.component_id == (std::vector<DefaultIx>{0, 0, 0, 1, 1, 2}));
+        }
+    }
+
+    GIVEN("A random directed graph")
+    {
+
+        std::mt19937 rng(8);
+        std::uniform_int_distribution<int> node(0, 299);
+        std::vector<std::pair<int, int>> edge_list;
+        for (int i = 0; i < 420; ++i) {
+            edge_list.emplace_back(node(rng), node(rng));
+        }
+        auto const graph = from_edges<DiGraph<int, int>>(edge_list, 300);
+        auto const tarjan = strongly_connected_components(graph);
+
+        THEN("Components are exactly the mutually reachable sets")
+        {
+            REQUIRE(tarjan.count > 1);
+            REQUIRE(tarjan.count < 300);
+            for (std::size_t u = 0; u < graph.node_count(); ++u) {
+                auto const forward = reachable_from(graph, u, Direction::Direction::Outgoing);
+                auto const backward = reachable_from(graph, u, Direction::Direction::Ingoing);
+                for (std::size_t v = 0; v < graph.node_count(); ++v) {
+                    REQUIRE((forward[v] && backward[v]) == (tarjan.component_id[u] == tarjan.component_id[v]));
+                }
+            }
+        }
+
+        THEN("Edges between components lead to smaller ids")
+        {
+            for (auto const& e : edge_list) {
+                REQUIRE(tarjan.component_id[e.first] >= tarjan.component_id[e.second]);
+            }
+        }
+
+        THEN("The parallel variant agrees for every thread count")
+        {
+            for (std::size_t threads : {1, 2, 4}) {
+                ThreadPool pool(threads);
+                REQUIRE(same_partition(tarjan, strongly_connected_components(graph, pool, 16)));
+                REQUIRE(same_partition(tarjan, strongly_connected_components(freeze(graph), pool, 16)));
+            }
+        }
+    }
+
+    GIVEN("Paths and cycles far deeper than any call stack")
+    {
+
+        int const n = 300000;
+        std::vector<std::pair<int, int>> path;
+        for (int i = 0; i + 1 < n; ++i) {
+            path.emplace_back(i, i + 1);
+        }
+        auto const line = from_edges<DiGraph<int, int>>(path);
+        path.emplace_back(n - 1, 0);
+        auto const ring = from_edges<DiGraph<int, int>>(path);
+        ThreadPool pool(2);
+
+        THEN("Every node of the path is its own component")
+        {
+            REQUIRE(strongly_connected_components(line).count == std::size_t(n));
+            REQUIRE(strongly_connected_components(line, pool).count == std::size_t(n));
+        }
+
+        THEN("The cycle is a single component")
+        {
+            REQUIRE(strongly_connected_components(ring).count == 1);
+            REQUIRE(strongly_connected_components(ring, pool).count == 1);
+        }
+    }
+}
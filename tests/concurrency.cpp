@@ -0,0 +1,187 @@
+#include "algorithms/query_batch.hpp"
+#include "builder.hpp"
+#include "csr.hpp"
+#include <catch.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+SCENARIO("Concurrent queries", "[concurrency]")
+{
+
+    GIVEN("A work-stealing loop over uneven items")
+    {
+
+        ThreadPool pool(4);
+        std::vector<std::atomic<int>> hits(10007);
+        for (auto& hit : hits) {
+            hit.store(0);
+        }
+
+        WHEN("Every item is run")
+        {
+
+            pool.steal_for(0, hits.size(), 3, [&](std::size_t first, std::size_t last, std::size_t id) {
+                for (auto i = first; i < last; ++i) {
+                    if (id == 0 && i % 97 == 0) {
+                        std::this_thread::yield();
+                    }
+                    hits[i].fetch_add(1);
+                }
+            });
+
+            THEN("Each item ran exactly once")
+            {
+                bool exactly_once = true;
+                for (auto const& hit : hits) {
+                    exactly_once = exactly_once && hit.load() == 1;
+                }
+                REQUIRE(exactly_once);
+            }
+        }
+    }
+
+    GIVEN("A pool whose jobs throw")
+    {
+
+        ThreadPool pool(4);
+        std::atomic<int> finished(0);
+
+        WHEN("The calling thread's call throws")
+        {
+
+            auto const job = [&](std::size_t id) {
+                if (id == 0) {
+                    throw std::runtime_error("caller");
+                }
+                std::this_thread::yield();
+                finished.fetch_add(1);
+            };
+
+            THEN("run waits for the workers and then rethrows")
+            {
+                REQUIRE_THROWS_WITH(pool.run(job), "caller");
+                REQUIRE(finished.load() == 3);
+            }
+        }
+
+        WHEN("Worker calls throw")
+        {
+
+            auto const job = [&](std::size_t id) {
+                if (id != 0) {
+                    throw std::runtime_error("worker");
+                }
+                finished.fetch_add(1);
+            };
+
+            THEN("run rethrows one of them and the pool stays usable")
+            {
+                REQUIRE_THROWS_WITH(pool.run(job), "worker");
+                REQUIRE(finished.load() == 1);
+                pool.run([&](std::size_t) { finished.fetch_add(1); });
+                REQUIRE(finished.load() == 5);
+            }
+        }
+    }
+
+    GIVEN("A shared random graph and a batch of queries")
+    {
+
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> node(0, 499);
+        std::uniform_int_distribution<int> cost(1, 9);
+        std::vector<std::tuple<int, int, int>> edges;
+        for (int i = 0; i < 1500; ++i) {
+            edges.emplace_back(node(rng), node(rng), cost(rng));
+        }
+        auto const graph = from_edges<DiGraph<int, int>>(edges, 500);
+        auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+
+        using Batch = QueryBatch<DiGraph<int, int>, std::int64_t>;
+        std::vector<Batch::query_t> queries;
+        for (int i = 0; i < 400; ++i) {
+            queries.emplace_back(NodeIndex<DefaultIx>(node(rng)), NodeIndex<DefaultIx>(node(rng)));
+        }
+
+        WHEN("The batch runs on four workers")
+        {
+
+            ThreadPool pool(4);
+            Batch batch(graph, pool);
+            auto const paths = batch.shortest_paths(queries, weight);
+            auto const reachable = batch.reachable(queries);
+            auto const again = batch.shortest_paths(queries, weight);
+
+            THEN("Results are in query order and match sequential searches")
+            {
+                REQUIRE(paths.size() == queries.size());
+                for (std::size_t i = 0; i < queries.size(); ++i) {
+                    auto const expected = bidirectional_dijkstra(graph, queries[i].first, queries[i].second, weight);
+                    REQUIRE(paths[i].distance == expected.distance);
+                    REQUIRE(again[i].distance == expected.distance);
+                    REQUIRE(reachable[i] == expected.found());
+                }
+            }
+        }
+
+        WHEN("A custom query returns bool")
+        {
+
+            ThreadPool pool(4);
+            Batch batch(graph, pool, 1);
+            auto const even = batch.run(queries, [](DiGraph<int, int> const&, Batch::query_t const& q, Batch::State&) {
+                return (q.first.index() + q.second.index()) % 2 == 0;
+            });
+
+            THEN("Every result lands in its own slot")
+            {
+                REQUIRE(even.size() == queries.size());
+                for (std::size_t i = 0; i < queries.size(); ++i) {
+                    REQUIRE(even[i] == ((queries[i].first.index() + queries[i].second.index()) % 2 == 0));
+                }
+            }
+        }
+
+        WHEN("Worker states allocate from a synchronized memory resource")
+        {
+
+            std::pmr::synchronized_pool_resource resource;
+            using Alloc = std::pmr::polymorphic_allocator<char>;
+            ThreadPool pool(4);
+            QueryBatch<DiGraph<int, int>, std::int64_t, Alloc> batch(graph, pool, 8, Alloc(&resource));
+            auto const paths = batch.shortest_paths(queries, weight);
+
+            THEN("Results match and the states use the resource")
+            {
+                REQUIRE(batch.states[0].search.forward.distance.get_allocator().resource() == &resource);
+                for (std::size_t i = 0; i < queries.size(); ++i) {
+                    REQUIRE(paths[i].distance == bidirectional_dijkstra(graph, queries[i].first, queries[i].second, weight).distance);
+                }
+            }
+        }
+
+        WHEN("A batch runs over a CSR snapshot")
+        {
+
+            ThreadPool pool(3);
+            auto const csr = freeze(graph);
+            QueryBatch<CsrGraph<int, int>, std::int64_t> batch(csr, pool);
+            auto const counts = batch.run(queries, [](CsrGraph<int, int> const& g, Batch::query_t const& q, auto&) {
+                return g.degree(q.first) + g.degree(q.second);
+            });
+
+            THEN("Custom queries see the same graph")
+            {
+                for (std::size_t i = 0; i < queries.size(); ++i) {
+                    REQUIRE(counts[i] == graph.degree(queries[i].first) + graph.degree(queries[i].second));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,203 @@
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "builder.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using RoadGraph = DiGraph<int, int>;
+
+int edge_weight(RoadGraph::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+/// Grid with one-way streets and a few random long links, so shortcuts and
+/// asymmetric distances both show up.
+RoadGraph test_network()
+{
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> cost(1, 30);
+    std::uniform_int_distribution<int> coin(0, 3);
+    int const side = 14;
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            auto const u = r * side + c;
+            if (c + 1 < side) {
+                edges.emplace_back(u, u + 1, cost(rng));
+                if (coin(rng) != 0) {
+                    edges.emplace_back(u + 1, u, cost(rng));
+                }
+            }
+            if (r + 1 < side) {
+                edges.emplace_back(u + side, u, cost(rng));
+                if (coin(rng) != 0) {
+                    edges.emplace_back(u, u + side, cost(rng));
+                }
+            }
+        }
+    }
+    std::uniform_int_distribution<int> node(0, side * side - 1);
+    for (int i = 0; i < 20; ++i) {
+        edges.emplace_back(node(rng), node(rng), 5 * cost(rng));
+    }
+    edges.emplace_back(3, 3, 1);
+    edges.emplace_back(0, 1, 100);
+    return from_edges<RoadGraph>(edges, side * side + 1);
+}
+
+/// Checks every pair of a sample against plain Dijkstra, including that the
+/// unpacked edges form a path of the reported cost.
+template <typename CH>
+bool matches_dijkstra(RoadGraph const& graph, CH const& ch)
+{
+    ChQueryWorkspace<DefaultIx, std::int64_t> ws;
+    for (std::size_t s = 0; s < graph.node_count(); s += 5) {
+        auto const source = NodeIndex<DefaultIx>(s);
+        auto const full = dijkstra(graph, source, edge_weight);
+        for (std::size_t t = 0; t < graph.node_count(); t += 3) {
+            auto const target = NodeIndex<DefaultIx>(t);
+            auto const path = ch.query(source, target, ws);
+            if (path.found() != full.reachable(target)) {
+                return false;
+            }
+            if (!path.found()) {
+                continue;
+            }
+            if (path.distance != full.distance_to(target) || path.nodes.size() != path.edges.size() + 1
+                || path.nodes.front() != source || path.nodes.back() != target) {
+                return false;
+            }
+            std::int64_t total = 0;
+            for (std::size_t i = 0; i < path.edges.size(); ++i) {
+                auto const ends = graph.edge_endpoints(path.edges[i]);
+                if (ends.first != path.nodes[i] || ends.second != path.nodes[i + 1]) {
+                    return false;
+                }
+                total += graph.edge_weight(path.edges[i]);
+            }
+            if (total != path.distance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+SCENARIO("Contraction hierarchies", "[contraction]")
+{
+
+    GIVEN("A one-way street network with an isolated node")
+    {
+
+        auto const graph = test_network();
+
+        WHEN("It is contracted sequentially")
+        {
+
+            auto const ch = contract(graph, edge_weight);
+
+            THEN("Every node gets a distinct rank")
+            {
+                std::vector<bool> seen(graph.node_count(), false);
+                for (auto const r : ch.rank) {
+                    REQUIRE(!seen[r]);
+                    seen[r] = true;
+                }
+            }
+
+            THEN("Queries return Dijkstra's distances with unpacked paths")
+            {
+                REQUIRE(ch.shortcut_count() > 0);
+                REQUIRE(matches_dijkstra(graph, ch));
+            }
+
+            THEN("Trivial and unreachable queries are handled")
+            {
+                auto const self = ch.query(NodeIndex<DefaultIx>(7), NodeIndex<DefaultIx>(7));
+                REQUIRE(self.distance == 0);
+                REQUIRE(self.edges.empty());
+                auto const isolated = NodeIndex<DefaultIx>(graph.node_count() - 1);
+                REQUIRE(!ch.query(NodeIndex<DefaultIx>(0), isolated).found());
+            }
+        }
+
+        WHEN("It is contracted on a thread pool")
+        {
+
+            ThreadPool pool(4);
+            ContractionOptions options;
+            options.pool = &pool;
+            auto const ch = contract(graph, edge_weight, options);
+
+            THEN("Queries are still exact")
+            {
+                REQUIRE(matches_dijkstra(graph, ch));
+            }
+        }
+
+        WHEN("A hierarchy is saved and loaded")
+        {
+
+            auto const ch = contract(graph, edge_weight);
+            std::string const path = "contraction_test.bin";
+            save_hierarchy(ch, path);
+            auto const loaded = load_hierarchy<DefaultIx, std::int64_t>(path);
+
+            THEN("The loaded hierarchy answers the same queries")
+            {
+                REQUIRE(loaded.rank == ch.rank);
+                REQUIRE(loaded.shortcut_count() == ch.shortcut_count());
+                REQUIRE(matches_dijkstra(graph, loaded));
+            }
+
+            THEN("Wrong types and corrupt files are rejected")
+            {
+                REQUIRE_THROWS_AS((load_hierarchy<DefaultIx, double>(path)), std::runtime_error);
+
+                std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+                file.seekp(sizeof(ContractionHierarchyHeader) + 3);
+                file.put('\x7f');
+                file.close();
+                REQUIRE_THROWS_AS((load_hierarchy<DefaultIx, std::int64_t>(path)), std::runtime_error);
+            }
+
+            std::remove(path.c_str());
+        }
+    }
+    GIVEN("A chain on the default char weights whose length exceeds char")
+    {
+
+        DiGraph<int, char> graph;
+        for (int i = 0; i < 5; ++i) {
+            graph.add_node(i);
+        }
+        for (DefaultIx i = 0; i < 4; ++i) {
+            graph.add_edge(NodeIndex<DefaultIx>(i), NodeIndex<DefaultIx>(i + 1), 125);
+        }
+        auto const weight = [](DiGraph<int, char>::edge_reference_t const& e) { return e.weight(); };
+        auto const ch = contract(graph, weight);
+
+        THEN("Shortcuts are summed without wrapping and match Dijkstra")
+        {
+            auto const full = dijkstra(graph, NodeIndex<DefaultIx>(0), weight);
+            for (std::size_t t = 0; t < 5; ++t) {
+                auto const path = ch.query(NodeIndex<DefaultIx>(0), NodeIndex<DefaultIx>(t));
+                REQUIRE(path.found());
+                REQUIRE(path.distance == full.distance_to(NodeIndex<DefaultIx>(t)));
+            }
+            REQUIRE(ch.query(NodeIndex<DefaultIx>(0), NodeIndex<DefaultIx>(4)).distance == 500);
+        }
+    }
+}
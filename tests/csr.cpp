@@ -0,0 +1,96 @@
+#include "csr.hpp"
+#include <catch.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+template <typename G>
+std::vector<std::pair<std::size_t, std::size_t>> sorted_adjacency(G const& graph, NodeIndex<DefaultIx> node, Direction::Direction dir)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    for (auto const& edge : graph.edges_directed(node, dir)) {
+        auto const other = dir == Direction::Direction::Outgoing ? edge.target() : edge.source();
+        result.push_back(std::make_pair(edge.id().index(), other.index()));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+SCENARIO("CSR snapshot", "[csr]")
+{
+
+    GIVEN("A directed graph with a self loop")
+    {
+
+        DiGraph<int, double> graph;
+        std::vector<NodeIndex<DefaultIx>> n;
+
+        for (int i = 0; i < 5; ++i) {
+            n.push_back(graph.add_node(i));
+        }
+        graph.add_edge(n[0], n[1], 1.5);
+        graph.add_edge(n[0], n[2], 2.5);
+        graph.add_edge(n[1], n[2], 3.5);
+        graph.add_edge(n[2], n[2], 4.5);
+        graph.add_edge(n[3], n[0], 5.5);
+
+        WHEN("The graph is frozen")
+        {
+
+            auto const csr = freeze(graph);
+
+            THEN("Counts and weights are preserved")
+            {
+                REQUIRE(csr.node_count() == graph.node_count());
+                REQUIRE(csr.edge_count() == graph.edge_count());
+                REQUIRE(csr.node_weight(n[3]) == 3);
+                REQUIRE(csr.edge_weight(EdgeIndex<DefaultIx>(2)) == 3.5);
+                REQUIRE(csr.degree(n[0]) == 2);
+                REQUIRE(csr.degree(n[2], Direction::Direction::Ingoing) == 3);
+            }
+
+            THEN("Both directions match the linked list adjacency")
+            {
+                for (auto node : n) {
+                    REQUIRE(sorted_adjacency(csr, node, Direction::Direction::Outgoing) == sorted_adjacency(graph, node, Direction::Direction::Outgoing));
+                    REQUIRE(sorted_adjacency(csr, node, Direction::Direction::Ingoing) == sorted_adjacency(graph, node, Direction::Direction::Ingoing));
+                }
+            }
+        }
+    }
+
+    GIVEN("An undirected graph with a self loop")
+    {
+
+        UnGraph<int, int> graph;
+        std::vector<NodeIndex<DefaultIx>> n;
+
+        for (int i = 0; i < 4; ++i) {
+            n.push_back(graph.add_node(i));
+        }
+        graph.add_edge(n[0], n[1], 1);
+        graph.add_edge(n[2], n[0], 2);
+        graph.add_edge(n[1], n[1], 3);
+
+        WHEN("The graph is frozen")
+        {
+
+            auto const csr = freeze(graph);
+
+            THEN("Every edge is listed from both endpoints and self loops once")
+            {
+                REQUIRE(csr.degree(n[0]) == 2);
+                REQUIRE(csr.degree(n[1]) == 2);
+                REQUIRE(csr.degree(n[3]) == 0);
+                for (auto node : n) {
+                    REQUIRE(sorted_adjacency(csr, node, Direction::Direction::Outgoing) == sorted_adjacency(graph, node, Direction::Direction::Outgoing));
+                }
+                for (auto const& edge : csr.edges_of(n[2])) {
+                    REQUIRE(edge.source() == n[2]);
+                    REQUIRE(edge.target() == n[0]);
+                    REQUIRE(edge.weight() == 2);
+                }
+            }
+        }
+    }
+}
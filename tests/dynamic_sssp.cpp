@@ -0,0 +1,167 @@
+#include "graph.hpp"
+#include "algorithms/dynamic_sssp.hpp"
+#include <catch.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Checks `live` against a fresh search and that its tree is consistent: every
+/// reached node's parent edge leads from its parent at exactly the difference
+/// of their distances.
+template <typename G, typename D>
+void check_against_dijkstra(G const& graph, D const& live)
+{
+    using Nx = NodeIndex<DefaultIx>;
+
+    auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+    auto const fresh = dijkstra(graph, live.source(), weight);
+    for (std::size_t i = 0; i < graph.node_count(); ++i) {
+        auto const v = Nx(i);
+        REQUIRE(live.distance_to(v) == fresh.distance_to(v));
+        auto const p = live.parent_of(v);
+        if (v == live.source() || !live.reachable(v)) {
+            REQUIRE(p == Nx::end());
+            continue;
+        }
+        auto const ends = graph.edge_endpoints(live.parent_edge_of(v));
+        REQUIRE(((ends.first == p && ends.second == v) || (!graph.is_directed() && ends.first == v && ends.second == p)));
+        REQUIRE(live.distance_to(p) + graph.edge_weight(live.parent_edge_of(v)) == live.distance_to(v));
+    }
+}
+
+template <typename G>
+void check_random_updates(unsigned seed, std::size_t batch)
+{
+    using Nx = NodeIndex<DefaultIx>;
+    using Ex = EdgeIndex<DefaultIx>;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> node(0, 149);
+    std::uniform_int_distribution<int> cost(1, 30);
+    std::uniform_int_distribution<int> action(0, 9);
+
+    G graph;
+    for (int i = 0; i < 150; ++i) {
+        graph.add_node(i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        graph.add_edge(Nx(node(rng)), Nx(node(rng)), cost(rng));
+    }
+
+    auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+    DynamicSssp live(graph, Nx(0), weight);
+    check_against_dijkstra(graph, live);
+
+    for (int round = 0; round < 40; ++round) {
+        std::vector<Ex> changed;
+        for (std::size_t k = 0; k < batch; ++k) {
+            auto const kind = action(rng);
+            if (kind == 0) {
+                changed.push_back(graph.add_edge(Nx(node(rng)), Nx(node(rng)), cost(rng)));
+                continue;
+            }
+            auto const e = Ex(std::uniform_int_distribution<DefaultIx>(0, static_cast<DefaultIx>(graph.edge_count() - 1))(rng));
+            auto& w = graph.edge_weight(e);
+            if (kind < 5) {
+                w += cost(rng);
+            }
+            else if (kind < 9) {
+                w = std::max(0, w - cost(rng));
+            }
+            else {
+                auto const a = graph.add_node(0);
+                changed.push_back(graph.add_edge(graph.edge_endpoints(e).second, a, cost(rng)));
+            }
+            changed.push_back(e);
+        }
+        live.update(changed.begin(), changed.end());
+        check_against_dijkstra(graph, live);
+    }
+}
+
+}
+
+SCENARIO("Maintaining shortest paths under edge updates", "[dynamic-sssp]")
+{
+
+    using Nx = NodeIndex<DefaultIx>;
+
+    GIVEN("A chain s -> a -> b -> c with a detour s -> c")
+    {
+
+        DiGraph<int, int> graph;
+        auto const s = graph.add_node(0);
+        auto const a = graph.add_node(1);
+        auto const b = graph.add_node(2);
+        auto const c = graph.add_node(3);
+        auto const sa = graph.add_edge(s, a, 1);
+        graph.add_edge(a, b, 1);
+        graph.add_edge(b, c, 1);
+        auto const sc = graph.add_edge(s, c, 10);
+
+        auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+        DynamicSssp live(graph, s, weight);
+        REQUIRE(live.distance_to(c) == 3);
+
+        WHEN("The first tree edge gets more expensive")
+        {
+            graph.edge_weight(sa) = 20;
+            live.update(sa);
+
+            THEN("Its subtree is rerouted over the detour")
+            {
+                REQUIRE(live.distance_to(a) == 20);
+                REQUIRE(live.distance_to(c) == 10);
+                REQUIRE(live.parent_edge_of(c) == sc);
+                REQUIRE(live.path_to(c) == (std::vector<Nx>{s, c}));
+                check_against_dijkstra(graph, live);
+            }
+        }
+
+        WHEN("A non-tree edge gets more expensive")
+        {
+            graph.edge_weight(sc) = 50;
+
+            THEN("Nothing needs to be settled")
+            {
+                REQUIRE(live.update(sc) == 0);
+                REQUIRE(live.distance_to(c) == 3);
+            }
+        }
+
+        WHEN("A shortcut is added to a new node")
+        {
+            auto const d = graph.add_node(4);
+            auto const sd = graph.add_edge(s, d, 1);
+            auto const db = graph.add_edge(d, b, 0);
+            std::vector<EdgeIndex<DefaultIx>> batch{sd, db};
+
+            THEN("Only the improved nodes are settled again")
+            {
+                REQUIRE(live.update(batch.begin(), batch.end()) == 3);
+                REQUIRE(live.distance_to(d) == 1);
+                REQUIRE(live.distance_to(b) == 1);
+                REQUIRE(live.distance_to(c) == 2);
+                check_against_dijkstra(graph, live);
+            }
+        }
+    }
+
+    GIVEN("Random graphs under random weight changes and insertions")
+    {
+
+        THEN("Single updates match a full recomputation")
+        {
+            check_random_updates<DiGraph<int, int>>(1, 1);
+            check_random_updates<UnGraph<int, int>>(2, 1);
+        }
+
+        THEN("Batched updates match a full recomputation")
+        {
+            check_random_updates<DiGraph<int, int>>(3, 12);
+            check_random_updates<UnGraph<int, int>>(4, 12);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#include "algorithms/dijkstra.hpp"
+#include "io/binary.hpp"
+#include "visit/dfsvisit.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+SCENARIO("Binary graph files", "[io]")
+{
+
+    GIVEN("A weighted directed graph saved to disk")
+    {
+
+        DiGraph<int, float> graph;
+        const int num_vertices = 500;
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<DefaultIx> pick(0, num_vertices - 1);
+        std::uniform_real_distribution<float> weight(1.0f, 5.0f);
+
+        for (int i = 0; i < num_vertices; ++i) {
+            graph.add_node(i * 3);
+        }
+        for (int i = 0; i < 4 * num_vertices; ++i) {
+            graph.add_edge(pick(rng), pick(rng), weight(rng));
+        }
+
+        std::string const path = "io_roundtrip_test.bin";
+        save_binary(graph, path);
+
+        WHEN("It is mapped back")
+        {
+
+            MappedGraph<int, float, true, DefaultIx> mapped(path, true);
+
+            THEN("Weights, endpoints and search results match the original")
+            {
+                REQUIRE(mapped.node_count() == graph.node_count());
+                REQUIRE(mapped.edge_count() == graph.edge_count());
+                REQUIRE(mapped.node_weight(NodeIndex<DefaultIx>(17)) == 51);
+                REQUIRE(mapped.edge_weight(EdgeIndex<DefaultIx>(9)) == graph.edge_weight(EdgeIndex<DefaultIx>(9)));
+                REQUIRE(mapped.edge_endpoints(EdgeIndex<DefaultIx>(9)) == graph.edge_endpoints(EdgeIndex<DefaultIx>(9)));
+
+                auto const cost = [](EdgeReference<float, DefaultIx> const& e) { return e.weight(); };
+                REQUIRE(dijkstra(mapped, NodeIndex<DefaultIx>(0), cost).distance == dijkstra(graph, NodeIndex<DefaultIx>(0), cost).distance);
+
+                std::size_t discovered = 0;
+                depth_first_search(mapped, NodeIndex<DefaultIx>(0), [&](DfsEvent<NodeIndex<DefaultIx>> const& event) {
+                    discovered += event.kind == DfsEvent<NodeIndex<DefaultIx>>::Kind::Discover;
+                });
+                REQUIRE(discovered > 1);
+            }
+
+            THEN("It can be copied into a mutable graph")
+            {
+                auto copy = mapped.to_graph();
+                copy.add_edge(NodeIndex<DefaultIx>(1), NodeIndex<DefaultIx>(2), 1.0f);
+                REQUIRE(copy.edge_count() == graph.edge_count() + 1);
+            }
+        }
+
+        WHEN("It is opened with the wrong index width")
+        {
+
+            THEN("Opening fails")
+            {
+                REQUIRE_THROWS_AS((MappedGraph<int, float, true, std::uint64_t>(path)), std::runtime_error);
+                REQUIRE_THROWS_AS((MappedGraph<int, float, false, DefaultIx>(path)), std::runtime_error);
+            }
+        }
+
+        WHEN("A payload byte is flipped")
+        {
+
+            {
+                std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+                file.seekp(-3, std::ios::end);
+                file.put('\x7f');
+            }
+
+            THEN("The header still opens but verification fails")
+            {
+                REQUIRE_NOTHROW((MappedGraph<int, float, true, DefaultIx>(path)));
+                REQUIRE_THROWS_AS((MappedGraph<int, float, true, DefaultIx>(path, true)), std::runtime_error);
+            }
+        }
+
+        std::remove(path.c_str());
+    }
+
+    GIVEN("A file that is not a graph")
+    {
+
+        std::string const path = "io_garbage_test.bin";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << std::string(200, 'x');
+        }
+
+        THEN("Opening fails")
+        {
+            REQUIRE_THROWS_AS((MappedGraph<int, float, true, DefaultIx>(path)), std::runtime_error);
+        }
+
+        std::remove(path.c_str());
+    }
+
+    GIVEN("A weightless graph saved to disk")
+    {
+
+        DiGraph<int, void> graph;
+        for (int i = 0; i < 4; ++i) {
+            graph.add_node(i);
+        }
+        graph.add_edge(NodeIndex<DefaultIx>(0), NodeIndex<DefaultIx>(1));
+        graph.add_edge(NodeIndex<DefaultIx>(1), NodeIndex<DefaultIx>(3));
+
+        std::string const path = "io_weightless_test.bin";
+        save_binary(graph, path);
+
+        THEN("It maps back with the same topology")
+        {
+            MappedGraph<int, void, true, DefaultIx> mapped(path, true);
+            REQUIRE(mapped.edge_count() == 2);
+            REQUIRE(mapped.edge_endpoints(EdgeIndex<DefaultIx>(1)) == graph.edge_endpoints(EdgeIndex<DefaultIx>(1)));
+            REQUIRE(mapped.degree(NodeIndex<DefaultIx>(1)) == 1);
+            REQUIRE(mapped.to_graph().edge_count() == 2);
+        }
+
+        std::remove(path.c_str());
+    }
+}
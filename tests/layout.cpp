@@ -0,0 +1,135 @@
+#include "graph.hpp"
+#include "builder.hpp"
+#include "csr.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename G>
+std::vector<std::pair<std::size_t, std::size_t>> adjacency(G const& graph, Direction::Direction dir)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    for (std::size_t u = 0; u < graph.node_count(); ++u) {
+        for (auto const& edge : graph.edges_directed(NodeIndex<typename G::index_t>(u), dir)) {
+            result.push_back(std::make_pair(edge.id().index(), edge.target().index() * 1000 + edge.source().index()));
+        }
+    }
+    return result;
+}
+
+}
+
+SCENARIO("Compact layouts", "[layout]")
+{
+
+    GIVEN("Edges without weights")
+    {
+
+        THEN("No storage is spent on the weight")
+        {
+            REQUIRE(sizeof(Edge<NoWeight, std::uint32_t>) == 16);
+            REQUIRE(sizeof(Edge<NoWeight, std::uint16_t>) == 8);
+            REQUIRE(sizeof(Graph<int, void>::edge_store_t::value_type) == 16);
+        }
+
+        THEN("A void-weighted graph supports traversal")
+        {
+            DiGraph<int, void> graph;
+            auto const a = graph.add_node(0);
+            auto const b = graph.add_node(1);
+            auto const c = graph.add_node(2);
+            graph.add_edge(a, b);
+            graph.add_edge(b, c);
+
+            SearchWorkspace<DefaultIx> ws;
+            breadth_first_search(graph, a, ws);
+            REQUIRE(ws.distance_to(c) == 2);
+            REQUIRE(freeze(graph).degree(b, Direction::Direction::Ingoing) == 1);
+        }
+    }
+
+    GIVEN("The same random graph in array-of-structs and struct-of-arrays storage")
+    {
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> node(0, 199);
+        std::uniform_int_distribution<int> cost(1, 50);
+        std::vector<std::tuple<int, int, int>> edge_list;
+        for (int i = 0; i < 1000; ++i) {
+            edge_list.emplace_back(node(rng), node(rng), cost(rng));
+        }
+
+        auto const aos = from_edges<DiGraph<int, int>>(edge_list, 200);
+        auto const soa = from_edges<DiGraph<int, int, DefaultIx, SoaStorage>>(edge_list, 200);
+
+        THEN("Both expose the same adjacency and weights")
+        {
+            REQUIRE(adjacency(aos, Direction::Direction::Outgoing) == adjacency(soa, Direction::Direction::Outgoing));
+            REQUIRE(adjacency(aos, Direction::Direction::Ingoing) == adjacency(soa, Direction::Direction::Ingoing));
+            for (std::size_t e = 0; e < aos.edge_count(); ++e) {
+                REQUIRE(aos.edge_weight(EdgeIndex<DefaultIx>(e)) == soa.edge_weight(EdgeIndex<DefaultIx>(e)));
+            }
+        }
+
+        THEN("Dijkstra finds the same distances")
+        {
+            auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+            auto const lhs = dijkstra(aos, NodeIndex<DefaultIx>(0), weight);
+            auto const rhs = dijkstra(soa, NodeIndex<DefaultIx>(0), weight);
+            REQUIRE(lhs.distance == rhs.distance);
+        }
+    }
+
+    GIVEN("A graph with 16-bit indices")
+    {
+
+        using Small = UnGraph<int, int, std::uint16_t>;
+        using Ix16 = NodeIndex<std::uint16_t>;
+
+        std::vector<std::tuple<int, int, int>> edge_list;
+        for (int i = 0; i + 1 < 1000; ++i) {
+            edge_list.emplace_back(i, i + 1, 1);
+        }
+        auto const graph = from_edges<Small>(edge_list);
+
+        THEN("An endpoint beyond the index type is rejected instead of wrapping")
+        {
+            std::vector<std::tuple<int, int, int>> wide = {std::make_tuple(0, 70000, 1)};
+            REQUIRE_THROWS_AS(from_edges<Small>(wide), std::invalid_argument);
+            std::vector<std::tuple<int, int, int>> negative = {std::make_tuple(-1, 0, 1)};
+            REQUIRE_THROWS_AS(from_edges<Small>(negative), std::invalid_argument);
+        }
+
+        THEN("Edges and nodes shrink to half the default size")
+        {
+            REQUIRE(sizeof(Edge<int, std::uint16_t>) == 12);
+            REQUIRE(graph.node_count() == 1000);
+        }
+
+        THEN("Searches run over the whole graph")
+        {
+            auto const weight = [](EdgeReference<int, std::uint16_t> const& e) { return e.weight(); };
+            auto const shortest = dijkstra(graph, Ix16(0), weight);
+            REQUIRE(shortest.distance_to(Ix16(999)) == 999);
+
+            std::size_t discovered = 0;
+            depth_first_search(graph, Ix16(0), [&](DfsEvent<Ix16> const& event) {
+                discovered += event.kind == DfsEvent<Ix16>::Kind::Discover;
+            });
+            REQUIRE(discovered == 1000);
+
+            ThreadPool pool(2);
+            auto const bfs = breadth_first_search(freeze(graph), Ix16(999), pool);
+            REQUIRE(bfs.depth[0] == 999);
+        }
+    }
+}
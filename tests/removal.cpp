@@ -0,0 +1,225 @@
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "csr.hpp"
+#include "io/binary.hpp"
+#include "reorder.hpp"
+#include "versioned_graph.hpp"
+#include <catch.hpp>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// Adjacency as (source, target, weight) triples per node, in chain order.
+template <typename G>
+std::vector<std::vector<std::tuple<std::size_t, std::size_t, int>>> adjacency(G const& graph, Direction::Direction dir)
+{
+    std::vector<std::vector<std::tuple<std::size_t, std::size_t, int>>> result(graph.node_count());
+    for (std::size_t u = 0; u < graph.node_count(); ++u) {
+        for (auto const& edge : graph.edges_directed(NodeIndex<DefaultIx>(u), dir)) {
+            result[u].emplace_back(edge.source().index(), edge.target().index(), edge.weight());
+        }
+    }
+    return result;
+}
+
+template <typename G>
+void check_removal_matches_rebuild(unsigned seed)
+{
+    using Nx = NodeIndex<DefaultIx>;
+    using Ex = EdgeIndex<DefaultIx>;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> node(0, 99);
+    std::uniform_int_distribution<int> cost(1, 20);
+
+    G graph;
+    for (int i = 0; i < 100; ++i) {
+        graph.add_node(i);
+    }
+    std::vector<std::tuple<int, int, int>> edge_list;
+    for (int i = 0; i < 600; ++i) {
+        edge_list.emplace_back(node(rng), node(rng), cost(rng));
+        graph.add_edge(Nx(std::get<0>(edge_list.back())), Nx(std::get<1>(edge_list.back())), std::get<2>(edge_list.back()));
+    }
+
+    std::set<int> removed_nodes;
+    std::set<std::size_t> removed_edges;
+    for (int i = 0; i < 10; ++i) {
+        auto const a = node(rng);
+        if (removed_nodes.insert(a).second) {
+            REQUIRE(graph.remove_node(Nx(a)) == a);
+        }
+    }
+    for (std::size_t e = 0; e < edge_list.size(); ++e) {
+        auto const& item = edge_list[e];
+        if (removed_nodes.count(std::get<0>(item)) || removed_nodes.count(std::get<1>(item))) {
+            REQUIRE(!graph.contains_edge(Ex(e)));
+            removed_edges.insert(e);
+        }
+        else if (e % 3 == 0) {
+            REQUIRE(graph.remove_edge(Ex(e)) == std::get<2>(item));
+            removed_edges.insert(e);
+        }
+    }
+    REQUIRE(graph.live_node_count() == 100 - removed_nodes.size());
+    REQUIRE(graph.live_edge_count() == edge_list.size() - removed_edges.size());
+
+    G rebuilt;
+    std::vector<Nx> renumbered(100);
+    for (int i = 0; i < 100; ++i) {
+        if (!removed_nodes.count(i)) {
+            renumbered[i] = rebuilt.add_node(i);
+        }
+    }
+    for (std::size_t e = 0; e < edge_list.size(); ++e) {
+        if (!removed_edges.count(e)) {
+            auto const& item = edge_list[e];
+            rebuilt.add_edge(renumbered[std::get<0>(item)], renumbered[std::get<1>(item)], std::get<2>(item));
+        }
+    }
+
+    auto const remap = graph.compact();
+    REQUIRE(!graph.has_vacancies());
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(remap.node(Nx(i)) == (removed_nodes.count(i) ? Nx::end() : renumbered[i]));
+    }
+    REQUIRE(graph.node_count() == rebuilt.node_count());
+    REQUIRE(graph.edge_count() == rebuilt.edge_count());
+    REQUIRE(adjacency(graph, Direction::Direction::Outgoing) == adjacency(rebuilt, Direction::Direction::Outgoing));
+    REQUIRE(adjacency(graph, Direction::Direction::Ingoing) == adjacency(rebuilt, Direction::Direction::Ingoing));
+    for (std::size_t i = 0; i < graph.node_count(); ++i) {
+        REQUIRE(graph.node_weight(Nx(i)) == rebuilt.node_weight(Nx(i)));
+    }
+}
+
+}
+
+SCENARIO("Removing nodes and edges", "[removal]")
+{
+
+    using Nx = NodeIndex<DefaultIx>;
+    using Ex = EdgeIndex<DefaultIx>;
+
+    GIVEN("A directed path a -> b -> c with a shortcut a -> c")
+    {
+
+        DiGraph<char, int> graph;
+        auto const a = graph.add_node('a');
+        auto const b = graph.add_node('b');
+        auto const c = graph.add_node('c');
+        auto const ab = graph.add_edge(a, b, 1);
+        auto const bc = graph.add_edge(b, c, 1);
+        auto const ac = graph.add_edge(a, c, 5);
+        auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+
+        WHEN("The middle edge is removed")
+        {
+            REQUIRE(graph.remove_edge(bc) == 1);
+
+            THEN("The other indices stay valid and searches take the detour")
+            {
+                REQUIRE(!graph.contains_edge(bc));
+                REQUIRE(graph.contains_edge(ab));
+                REQUIRE(graph.edge_endpoints(ac) == std::make_pair(a, c));
+                REQUIRE(graph.degree(b) == 0);
+                REQUIRE(graph.degree(c, Direction::Direction::Ingoing) == 1);
+                REQUIRE(graph.edge_count() == 3);
+                REQUIRE(graph.live_edge_count() == 2);
+                REQUIRE(dijkstra(graph, a, weight).distance_to(c) == 5);
+            }
+
+            THEN("Freezing, saving, reordering and versioning refuse it until compact()")
+            {
+                std::string const path = "removal_test.bin";
+                REQUIRE_THROWS_AS(freeze(graph), std::logic_error);
+                REQUIRE_THROWS_AS(save_binary(graph, path), std::logic_error);
+                REQUIRE_THROWS_AS(reorder(graph, NodeOrder::ReverseCuthillMcKee), std::logic_error);
+                REQUIRE_THROWS_AS((VersionedGraph<char, int>(graph)), std::logic_error);
+
+                graph.compact();
+                REQUIRE(freeze(graph).edge_count() == 2);
+                save_binary(graph, path);
+                REQUIRE((MappedGraph<char, int, true, DefaultIx>(path).edge_count() == 2));
+                std::remove(path.c_str());
+            }
+
+            THEN("The next added edge reuses its slot")
+            {
+                auto const cb = graph.add_edge(c, b, 2);
+                REQUIRE(cb == bc);
+                REQUIRE(graph.edge_count() == 3);
+                REQUIRE(graph.edge_endpoints(cb) == std::make_pair(c, b));
+                REQUIRE(graph.edge_weight(cb) == 2);
+                REQUIRE(dijkstra(graph, a, weight).distance_to(b) == 1);
+            }
+        }
+
+        WHEN("The middle node is removed")
+        {
+            REQUIRE(graph.remove_node(b) == 'b');
+
+            THEN("Its edges go with it and the node slot is reused")
+            {
+                REQUIRE(!graph.contains_node(b));
+                REQUIRE(!graph.contains_edge(ab));
+                REQUIRE(!graph.contains_edge(bc));
+                REQUIRE(graph.degree(a) == 1);
+                REQUIRE(graph.live_node_count() == 2);
+
+                auto const d = graph.add_node('d');
+                REQUIRE(d == b);
+                REQUIRE(graph.contains_node(d));
+                REQUIRE(graph.degree(d) == 0);
+            }
+
+            THEN("Compaction renumbers densely")
+            {
+                auto const remap = graph.compact();
+                REQUIRE(graph.node_count() == 2);
+                REQUIRE(graph.edge_count() == 1);
+                REQUIRE(remap.node(b) == Nx::end());
+                REQUIRE(remap.node(c) == Nx(1));
+                REQUIRE(remap.edge(ab) == Ex::end());
+                REQUIRE(remap.edge(ac) == Ex(0));
+                REQUIRE(graph.node_weight(remap.node(c)) == 'c');
+                REQUIRE(graph.edge_endpoints(Ex(0)) == std::make_pair(Nx(0), Nx(1)));
+            }
+        }
+    }
+
+    GIVEN("An undirected graph with a self loop")
+    {
+
+        UnGraph<int, int> graph;
+        auto const a = graph.add_node(0);
+        auto const b = graph.add_node(1);
+        auto const loop = graph.add_edge(a, a, 7);
+        graph.add_edge(a, b, 1);
+
+        THEN("Removing the loop unlinks it from both chains of its node")
+        {
+            REQUIRE(graph.degree(a) == 2);
+            graph.remove_edge(loop);
+            REQUIRE(graph.degree(a) == 1);
+            REQUIRE(graph.degree(b) == 1);
+        }
+    }
+
+    GIVEN("Random graphs with a batch of removals")
+    {
+
+        THEN("Compaction gives the graph built from the survivors")
+        {
+            check_removal_matches_rebuild<DiGraph<int, int>>(1);
+            check_removal_matches_rebuild<UnGraph<int, int>>(2);
+            check_removal_matches_rebuild<DiGraph<int, int, DefaultIx, SoaStorage>>(3);
+        }
+    }
+}
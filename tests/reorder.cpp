@@ -0,0 +1,189 @@
+#include "graph.hpp"
+#include "reorder.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "builder.hpp"
+#include <catch.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Graph_t = DiGraph<int, int>;
+
+/// Grid of `side` x `side` nodes with edges both ways between neighbours,
+/// ids shuffled so that neighbours are far apart. `position[v]` receives the
+/// (column, row) of node `v`.
+Graph_t shuffled_grid(int side, std::vector<std::pair<int, int>>& position)
+{
+    std::vector<int> id(static_cast<std::size_t>(side * side));
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), std::mt19937(12));
+    position.assign(id.size(), {});
+    std::vector<std::tuple<int, int, int>> edge_list;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            auto const u = id[r * side + c];
+            position[u] = std::make_pair(c, r);
+            if (c + 1 < side) {
+                edge_list.emplace_back(u, id[r * side + c + 1], 1 + (r + c) % 7);
+                edge_list.emplace_back(id[r * side + c + 1], u, 1 + (r + c) % 7);
+            }
+            if (r + 1 < side) {
+                edge_list.emplace_back(u, id[(r + 1) * side + c], 1 + (r * c) % 5);
+                edge_list.emplace_back(id[(r + 1) * side + c], u, 1 + (r * c) % 5);
+            }
+        }
+    }
+    auto graph = from_edges<Graph_t>(edge_list, id.size());
+    for (std::size_t v = 0; v < id.size(); ++v) {
+        graph.node_weight(NodeIndex<DefaultIx>(v)) = static_cast<int>(v);
+    }
+    return graph;
+}
+
+/// Largest index distance between the ends of an edge.
+template <typename G>
+std::size_t bandwidth(G const& graph)
+{
+    std::size_t widest = 0;
+    for (std::size_t e = 0; e < graph.edge_count(); ++e) {
+        auto const& links = graph.edges.links(e);
+        auto const a = links.source().index();
+        auto const b = links.target().index();
+        widest = std::max(widest, a < b ? b - a : a - b);
+    }
+    return widest;
+}
+
+std::multiset<std::tuple<std::size_t, std::size_t, int>> edge_set(Graph_t const& graph)
+{
+    std::multiset<std::tuple<std::size_t, std::size_t, int>> result;
+    for (std::size_t e = 0; e < graph.edge_count(); ++e) {
+        auto const& links = graph.edges.links(e);
+        result.emplace(links.source().index(), links.target().index(), graph.edges.weight(e));
+    }
+    return result;
+}
+
+int edge_weight(Graph_t::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+}
+
+SCENARIO("Reordering a graph", "[reorder]")
+{
+
+    GIVEN("A grid with shuffled node ids")
+    {
+
+        std::vector<std::pair<int, int>> position;
+        auto const original = shuffled_grid(24, position);
+        auto const before = dijkstra(original, NodeIndex<DefaultIx>(5), edge_weight);
+        auto const at = [&](NodeIndex<DefaultIx> v) { return position[v.index()]; };
+
+        for (auto strategy : {NodeOrder::ReverseCuthillMcKee, NodeOrder::BreadthFirst, NodeOrder::Degree, NodeOrder::Hilbert}) {
+            auto graph = original;
+            auto const map = reorder(graph, strategy, at);
+
+            THEN("Both maps are inverse permutations")
+            {
+                REQUIRE(map.old_to_new.size() == original.node_count());
+                REQUIRE(map.new_to_old.size() == original.node_count());
+                for (std::size_t v = 0; v < original.node_count(); ++v) {
+                    auto const old = NodeIndex<DefaultIx>(v);
+                    REQUIRE(map.to_old(map.to_new(old)) == old);
+                }
+            }
+
+            THEN("Node weights, edges and edge indices follow the maps")
+            {
+                REQUIRE(graph.node_count() == original.node_count());
+                REQUIRE(graph.edge_count() == original.edge_count());
+                for (std::size_t v = 0; v < original.node_count(); ++v) {
+                    auto const old = NodeIndex<DefaultIx>(v);
+                    REQUIRE(graph.node_weight(map.to_new(old)) == original.node_weight(old));
+                }
+                std::multiset<std::tuple<std::size_t, std::size_t, int>> expected;
+                for (std::size_t e = 0; e < original.edge_count(); ++e) {
+                    auto const& links = original.edges.links(e);
+                    auto const moved = map.edge_to_new(EdgeIndex<DefaultIx>(e)).index();
+                    REQUIRE(graph.edges.links(moved).source() == map.to_new(links.source()));
+                    REQUIRE(graph.edges.links(moved).target() == map.to_new(links.target()));
+                    REQUIRE(graph.edges.weight(moved) == original.edges.weight(e));
+                    expected.emplace(map.to_new(links.source()).index(), map.to_new(links.target()).index(),
+                                     original.edges.weight(e));
+                }
+                REQUIRE(edge_set(graph) == expected);
+            }
+
+            THEN("Shortest distances are unchanged")
+            {
+                auto const after = dijkstra(graph, map.to_new(NodeIndex<DefaultIx>(5)), edge_weight);
+                for (std::size_t v = 0; v < original.node_count(); ++v) {
+                    REQUIRE(after.distance[map.to_new(NodeIndex<DefaultIx>(v)).index()] == before.distance[v]);
+                }
+            }
+        }
+
+        THEN("Reverse Cuthill-McKee brings the bandwidth close to the grid side")
+        {
+            auto graph = original;
+            reorder(graph, NodeOrder::ReverseCuthillMcKee);
+            REQUIRE(bandwidth(original) > 200);
+            REQUIRE(bandwidth(graph) <= 2 * 24);
+        }
+
+        THEN("Hilbert order keeps grid neighbours nearby on average")
+        {
+            auto graph = original;
+            reorder(graph, NodeOrder::Hilbert, at);
+            std::size_t total = 0;
+            for (std::size_t e = 0; e < graph.edge_count(); ++e) {
+                auto const& links = graph.edges.links(e);
+                auto const a = links.source().index();
+                auto const b = links.target().index();
+                total += a < b ? b - a : a - b;
+            }
+            REQUIRE(total / graph.edge_count() < 16);
+        }
+
+        THEN("Hilbert order without positions is rejected")
+        {
+            auto graph = original;
+            REQUIRE_THROWS_AS(reorder(graph, NodeOrder::Hilbert), std::invalid_argument);
+        }
+    }
+
+    GIVEN("A disconnected undirected graph with a self loop")
+    {
+
+        std::vector<std::pair<int, int>> edge_list{{0, 5}, {5, 3}, {2, 2}, {4, 1}};
+        auto graph = from_edges<UnGraph<int, int>>(edge_list, 7);
+
+        THEN("Every component is ordered and chains are walkable")
+        {
+            auto const map = reorder(graph, NodeOrder::ReverseCuthillMcKee);
+            std::vector<DefaultIx> seen;
+            for (auto v : map.new_to_old) {
+                seen.push_back(v.index());
+            }
+            std::sort(seen.begin(), seen.end());
+            REQUIRE(seen == (std::vector<DefaultIx>{0, 1, 2, 3, 4, 5, 6}));
+            std::set<DefaultIx> around_five;
+            auto const five = map.to_new(NodeIndex<DefaultIx>(5));
+            for (auto const& edge : graph.edges_of(five)) {
+                auto const other = edge.source() == five ? edge.target() : edge.source();
+                around_five.insert(map.to_old(other).index());
+            }
+            REQUIRE(around_five == (std::set<DefaultIx>{0, 3}));
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include "graph.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/search_stats.hpp"
+#include "builder.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
+#include <catch.hpp>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using Graph_t = DiGraph<int, int>;
+using Event = DfsEvent<NodeIndex<DefaultIx>>;
+
+int edge_weight(Graph_t::edge_reference_t const& e)
+{
+    return e.weight();
+}
+
+}
+
+static_assert(std::is_empty<NoStats>::value, "the disabled policy must carry no state");
+
+SCENARIO("Search statistics", "[stats]")
+{
+
+    GIVEN("A diamond whose direct edge is later improved, plus an unreachable node")
+    {
+
+        std::vector<std::tuple<int, int, int>> edge_list{{0, 1, 1}, {0, 2, 5}, {1, 2, 1}, {2, 3, 1}, {4, 0, 1}};
+        auto const graph = from_edges<Graph_t>(edge_list);
+        auto const start = NodeIndex<DefaultIx>(0);
+        auto const none = NodeIndex<DefaultIx>::end();
+
+        THEN("Dijkstra counts pushes, decreases and the heap high-water mark")
+        {
+            SearchWorkspace<DefaultIx, int> ws;
+            SearchStats stats;
+            dijkstra(graph, start, edge_weight, ws, none, stats);
+            REQUIRE(stats.kind == SearchKind::Dijkstra);
+            REQUIRE(stats.counters.nodes_discovered == 4);
+            REQUIRE(stats.counters.nodes_settled == 4);
+            REQUIRE(stats.counters.edges_relaxed == 4);
+            REQUIRE(stats.counters.heap_pushes == 4);
+            REQUIRE(stats.counters.heap_decreases == 1);
+            REQUIRE(stats.counters.peak_frontier == 2);
+            REQUIRE(ws.distance_to(NodeIndex<DefaultIx>(3)) == 3);
+        }
+
+        THEN("Counters restart with every query and stop with the target")
+        {
+            DijkstraResult<DefaultIx, int> result;
+            SearchStats stats;
+            dijkstra(graph, start, edge_weight, result, none, stats);
+            dijkstra(graph, start, edge_weight, result, NodeIndex<DefaultIx>(1), stats);
+            REQUIRE(stats.counters.nodes_settled == 2);
+            REQUIRE(stats.counters.edges_relaxed == 2);
+            REQUIRE(result.distance_to(NodeIndex<DefaultIx>(1)) == 1);
+        }
+
+        THEN("Breadth-first search counts dequeued nodes as settled and no heap work")
+        {
+            SearchWorkspace<DefaultIx> ws;
+            SearchStats stats;
+            breadth_first_search(graph, start, ws, none, stats);
+            REQUIRE(stats.kind == SearchKind::BreadthFirst);
+            REQUIRE(stats.counters.nodes_discovered == 4);
+            REQUIRE(stats.counters.nodes_settled == 4);
+            REQUIRE(stats.counters.edges_relaxed == 4);
+            REQUIRE(stats.counters.heap_pushes == 0);
+            REQUIRE(stats.counters.peak_frontier == 2);
+        }
+
+        THEN("Depth-first search reports the deepest stack, 0-2-3 as chains run newest first")
+        {
+            DfsWorkspace<Graph_t> ws;
+            SearchStats stats;
+            depth_first_search(graph, start, [](Event const&) {}, ws, stats);
+            REQUIRE(stats.kind == SearchKind::DepthFirst);
+            REQUIRE(stats.counters.nodes_discovered == 4);
+            REQUIRE(stats.counters.nodes_settled == 4);
+            REQUIRE(stats.counters.edges_relaxed == 4);
+            REQUIRE(stats.counters.peak_frontier == 3);
+
+            depth_first_search(graph, std::vector<NodeIndex<DefaultIx>>{start, NodeIndex<DefaultIx>(4)},
+                               [](Event const&) {}, ws, stats);
+            REQUIRE(stats.counters.nodes_discovered == 5);
+            REQUIRE(stats.counters.edges_relaxed == 5);
+        }
+
+        THEN("A traced policy hands every finished query to its hook")
+        {
+            std::vector<SearchTrace> traces;
+            TracedStats stats([&](SearchTrace const& trace) { traces.push_back(trace); });
+            SearchWorkspace<DefaultIx, int> ws;
+            DfsWorkspace<Graph_t> dfs;
+            dijkstra(graph, start, edge_weight, ws, none, stats);
+            breadth_first_search(graph, start, ws, none, stats);
+            depth_first_search(graph, start, [](Event const&) { return ControlFlow<NoData>::Break(); }, dfs, stats);
+            REQUIRE(traces.size() == 3);
+            REQUIRE(traces[0].kind == SearchKind::Dijkstra);
+            REQUIRE(traces[0].counters.heap_decreases == 1);
+            REQUIRE(traces[1].kind == SearchKind::BreadthFirst);
+            REQUIRE(traces[2].kind == SearchKind::DepthFirst);
+            REQUIRE(traces[2].counters.nodes_discovered == 1);
+            for (auto const& trace : traces) {
+                REQUIRE(trace.elapsed.count() >= 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,499 @@
+#include "algorithms/contraction_hierarchy.hpp"
+#include "algorithms/delta_stepping.hpp"
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/point_to_point.hpp"
+#include "algorithms/shortest_paths.hpp"
+#include "builder.hpp"
+#include "csr.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+SCENARIO("Shortest paths", "[shortest-paths]")
+{
+
+    GIVEN("A weighted directed graph")
+    {
+
+        DiGraph<int, int> graph;
+        std::vector<NodeIndex<DefaultIx>> n;
+
+        for (int i = 0; i < 6; ++i) {
+            n.push_back(graph.add_node(i));
+        }
+        graph.add_edge(n[0], n[1], 7);
+        graph.add_edge(n[0], n[2], 9);
+        graph.add_edge(n[0], n[5], 14);
+        graph.add_edge(n[1], n[2], 10);
+        graph.add_edge(n[1], n[3], 15);
+        graph.add_edge(n[2], n[3], 11);
+        graph.add_edge(n[2], n[5], 2);
+        graph.add_edge(n[3], n[4], 6);
+        graph.add_edge(n[5], n[4], 9);
+
+        auto const weight = [](DiGraph<int, int>::edge_reference_t const& e) { return e.weight(); };
+
+        WHEN("Dijkstra runs from the first node")
+        {
+
+            auto const result = dijkstra(graph, n[0], weight);
+
+            THEN("Distances and paths are the shortest ones")
+            {
+                std::vector<std::int64_t> expected = {0, 7, 9, 20, 20, 11};
+                REQUIRE(result.distance == expected);
+                std::vector<NodeIndex<DefaultIx>> path = {n[0], n[2], n[5], n[4]};
+                REQUIRE(result.path_to(n[4]) == path);
+                REQUIRE(graph.edge_endpoints(result.parent_edge[n[4].index()]).first == n[5]);
+            }
+        }
+
+        WHEN("Dijkstra runs against the CSR snapshot")
+        {
+
+            auto const csr = freeze(graph);
+
+            THEN("It produces the same distances")
+            {
+                REQUIRE(dijkstra(csr, n[0], weight).distance == dijkstra(graph, n[0], weight).distance);
+            }
+        }
+
+        WHEN("Dijkstra runs from a node that reaches nothing")
+        {
+
+            auto const result = dijkstra(graph, n[4], weight);
+
+            THEN("Every other node is unreachable")
+            {
+                REQUIRE(result.distance_to(n[4]) == 0);
+                REQUIRE(!result.reachable(n[0]));
+                REQUIRE(result.path_to(n[0]).empty());
+            }
+        }
+
+        WHEN("A target is given and the result object is reused")
+        {
+
+            DijkstraResult<DefaultIx, int> result;
+            dijkstra(graph, n[4], weight, result);
+            dijkstra(graph, n[0], weight, result, n[2]);
+
+            THEN("The target distance is final")
+            {
+                REQUIRE(result.source == n[0]);
+                REQUIRE(result.distance_to(n[2]) == 9);
+                REQUIRE(result.distance_to(n[1]) == 7);
+            }
+        }
+    }
+
+    GIVEN("A path graph searched repeatedly with one workspace")
+    {
+
+        DiGraph<int, int> graph;
+        std::vector<NodeIndex<DefaultIx>> n;
+
+        for (int i = 0; i < 5; ++i) {
+            n.push_back(graph.add_node(i));
+        }
+        for (int i = 0; i < 4; ++i) {
+            graph.add_edge(n[i], n[i + 1], 1);
+        }
+
+        auto const weight = [](DiGraph<int, int>::edge_reference_t const& e) { return e.weight(); };
+        SearchWorkspace<DefaultIx, int> ws;
+
+        WHEN("A later query reaches fewer nodes than an earlier one")
+        {
+
+            dijkstra(graph, n[0], weight, ws);
+            auto const capacity = ws.stamp.capacity();
+            dijkstra(graph, n[3], weight, ws);
+
+            THEN("Stale entries from the earlier query are not visible")
+            {
+                REQUIRE(ws.distance_to(n[4]) == 1);
+                REQUIRE(!ws.reachable(n[1]));
+                REQUIRE(ws.parent_of(n[2]) == NodeIndex<DefaultIx>::end());
+                REQUIRE(ws.path_to(n[4]).size() == 2);
+                REQUIRE(ws.stamp.capacity() == capacity);
+            }
+        }
+    }
+
+    GIVEN("An undirected graph")
+    {
+
+        UnGraph<int, double> graph;
+        auto a = graph.add_node(0);
+        auto b = graph.add_node(1);
+        auto c = graph.add_node(2);
+        graph.add_edge(b, a, 1.5);
+        graph.add_edge(c, b, 2.0);
+
+        WHEN("Dijkstra runs from an endpoint")
+        {
+
+            auto const result = dijkstra(graph, a, [](UnGraph<int, double>::edge_reference_t const& e) { return e.weight(); });
+
+            THEN("Edges are followed in both directions")
+            {
+                REQUIRE(result.distance_to(c) == 3.5);
+            }
+        }
+    }
+
+    GIVEN("A random directed graph and a grid")
+    {
+
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<int> node(0, 299);
+        std::uniform_int_distribution<int> cost(1, 20);
+        std::vector<std::tuple<int, int, int>> random_edges;
+        for (int i = 0; i < 1200; ++i) {
+            random_edges.emplace_back(node(rng), node(rng), cost(rng));
+        }
+        auto const random = from_edges<DiGraph<int, int>>(random_edges, 300);
+
+        int const side = 20;
+        std::vector<std::tuple<int, int, int>> grid_edges;
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                if (c + 1 < side) {
+                    grid_edges.emplace_back(r * side + c, r * side + c + 1, cost(rng));
+                }
+                if (r + 1 < side) {
+                    grid_edges.emplace_back(r * side + c, (r + 1) * side + c, cost(rng));
+                }
+            }
+        }
+        auto const grid = from_edges<UnGraph<int, int>>(grid_edges);
+
+        auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+        auto const path_cost = [](auto const& graph, auto const& path) {
+            std::int64_t total = 0;
+            for (std::size_t i = 0; i < path.edges.size(); ++i) {
+                auto const ends = graph.edge_endpoints(path.edges[i]);
+                bool const forward = ends.first == path.nodes[i] && ends.second == path.nodes[i + 1];
+                bool const backward = !graph.is_directed() && ends.second == path.nodes[i] && ends.first == path.nodes[i + 1];
+                if (!forward && !backward) {
+                    return std::int64_t(-1);
+                }
+                total += graph.edge_weight(path.edges[i]);
+            }
+            return total;
+        };
+
+        WHEN("Point-to-point searches run between many pairs")
+        {
+
+            BidirectionalWorkspace<DefaultIx, int> bidirectional_ws;
+            SearchWorkspace<DefaultIx, int> astar_ws;
+            auto const zero = [](NodeIndex<DefaultIx>) { return 0; };
+
+            THEN("They agree with Dijkstra and return valid paths")
+            {
+                for (int s = 0; s < 300; s += 7) {
+                    auto const full = dijkstra(random, NodeIndex<DefaultIx>(s), weight);
+                    for (int t = 0; t < 300; t += 11) {
+                        auto const target = NodeIndex<DefaultIx>(t);
+                        auto const bi = bidirectional_dijkstra(random, NodeIndex<DefaultIx>(s), target, weight, bidirectional_ws);
+                        auto const directed = astar(random, NodeIndex<DefaultIx>(s), target, weight, zero, astar_ws);
+                        REQUIRE(bi.found() == full.reachable(target));
+                        REQUIRE(directed.found() == full.reachable(target));
+                        if (full.reachable(target)) {
+                            REQUIRE(bi.distance == full.distance_to(target));
+                            REQUIRE(directed.distance == full.distance_to(target));
+                            REQUIRE(path_cost(random, bi) == bi.distance);
+                            REQUIRE(path_cost(random, directed) == directed.distance);
+                            REQUIRE(bi.nodes.front() == NodeIndex<DefaultIx>(s));
+                            REQUIRE(bi.nodes.back() == target);
+                        }
+                    }
+                }
+            }
+
+            THEN("A* with a consistent heuristic settles fewer nodes on a grid")
+            {
+                auto const target = NodeIndex<DefaultIx>(side * side - 1);
+                auto const manhattan = [&](NodeIndex<DefaultIx> v) {
+                    auto const r = static_cast<int>(v.index()) / side;
+                    auto const c = static_cast<int>(v.index()) % side;
+                    return std::abs(side - 1 - r) + std::abs(side - 1 - c);
+                };
+                auto const guided = astar(grid, NodeIndex<DefaultIx>(0), target, weight, manhattan);
+                auto const blind = astar(grid, NodeIndex<DefaultIx>(0), target, weight, zero);
+                auto const bi = bidirectional_dijkstra(grid, NodeIndex<DefaultIx>(0), target, weight);
+
+                REQUIRE(guided.distance == blind.distance);
+                REQUIRE(bi.distance == blind.distance);
+                REQUIRE(path_cost(grid, bi) == bi.distance);
+                REQUIRE(guided.settled <= blind.settled);
+            }
+        }
+
+        WHEN("Delta-stepping runs with several bucket widths and thread counts")
+        {
+
+            auto const tree_is_consistent = [&](auto const& graph, DijkstraResult<DefaultIx, std::int64_t> const& result) {
+                for (std::size_t i = 0; i < graph.node_count(); ++i) {
+                    auto const v = NodeIndex<DefaultIx>(i);
+                    if (!result.reachable(v) || v == result.source) {
+                        continue;
+                    }
+                    auto const e = result.parent_edge[i];
+                    auto const ends = graph.edge_endpoints(e);
+                    auto const p = result.parent[i];
+                    bool const forward = ends.first == p && ends.second == v;
+                    bool const backward = !graph.is_directed() && ends.second == p && ends.first == v;
+                    if ((!forward && !backward) || result.distance[p.index()] + graph.edge_weight(e) != result.distance[i]) {
+                        return false;
+                    }
+                    if (result.path_to(v).front() != result.source) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            THEN("Distances equal Dijkstra's and the tree is a shortest-path tree")
+            {
+                for (std::size_t threads : {1, 3}) {
+                    ThreadPool pool(threads);
+                    for (std::int64_t delta : {1, 5, 20, 1000}) {
+                        for (int s : {0, 17, 123}) {
+                            auto const expected = dijkstra(random, NodeIndex<DefaultIx>(s), weight);
+                            auto const parallel = delta_stepping(random, NodeIndex<DefaultIx>(s), weight, delta, pool, 8);
+                            REQUIRE(parallel.distance == expected.distance);
+                            REQUIRE(tree_is_consistent(random, parallel));
+                        }
+                        auto const expected = dijkstra(grid, NodeIndex<DefaultIx>(0), weight);
+                        auto const parallel = delta_stepping(grid, NodeIndex<DefaultIx>(0), weight, delta, pool, 8);
+                        REQUIRE(parallel.distance == expected.distance);
+                        REQUIRE(tree_is_consistent(grid, parallel));
+                    }
+                }
+            }
+        }
+
+        WHEN("Source and target coincide")
+        {
+
+            auto const same = bidirectional_dijkstra(random, NodeIndex<DefaultIx>(5), NodeIndex<DefaultIx>(5), weight);
+
+            THEN("The path is the single node")
+            {
+                REQUIRE(same.distance == 0);
+                REQUIRE(same.nodes.size() == 1);
+                REQUIRE(same.edges.empty());
+            }
+        }
+    }
+
+    GIVEN("A long chain with heavy shortcuts, far longer than the bucket ring")
+    {
+
+        std::vector<std::tuple<int, int, int>> edge_list;
+        for (int i = 0; i + 1 < 2000; ++i) {
+            edge_list.emplace_back(i, i + 1, 7);
+            if (i % 13 == 0 && i + 9 < 2000) {
+                edge_list.emplace_back(i, i + 9, 50);
+            }
+        }
+        auto const graph = from_edges<DiGraph<int, int>>(edge_list, 2000);
+        auto const weight = [](EdgeReference<int, DefaultIx> const& e) { return e.weight(); };
+
+        THEN("Delta-stepping wraps its ring many times and still matches Dijkstra")
+        {
+            ThreadPool pool(3);
+            auto const expected = dijkstra(graph, NodeIndex<DefaultIx>(0), weight);
+            for (std::int64_t delta : {1, 3, 7, 49}) {
+                REQUIRE(delta_stepping(graph, NodeIndex<DefaultIx>(0), weight, delta, pool, 4).distance == expected.distance);
+            }
+        }
+    }
+
+    GIVEN("Float costs with many zero-cost edges")
+    {
+
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> node(0, 499);
+        std::uniform_real_distribution<float> cost(0.0f, 3.0f);
+        std::vector<std::tuple<int, int, float>> edge_list;
+        for (int i = 0; i < 3000; ++i) {
+            auto const c = cost(rng);
+            edge_list.emplace_back(node(rng), node(rng), c < 1.0f ? 0.0f : c);
+        }
+        auto const graph = from_edges<DiGraph<int, float>>(edge_list, 500);
+        auto const frozen = freeze(graph);
+        auto const weight = [](EdgeReference<float, DefaultIx> const& e) { return e.weight(); };
+
+        THEN("Delta-stepping matches Dijkstra bit for bit and its tree has no cycles")
+        {
+            ThreadPool pool(4);
+            auto const expected = dijkstra(graph, NodeIndex<DefaultIx>(0), weight);
+            for (float delta : {0.25f, 1.0f, 4.0f}) {
+                auto const parallel = delta_stepping(graph, NodeIndex<DefaultIx>(0), weight, delta, pool, 4);
+                auto const on_csr = delta_stepping(frozen, NodeIndex<DefaultIx>(0), weight, delta, pool, 4);
+                REQUIRE(parallel.distance == expected.distance);
+                REQUIRE(on_csr.distance == expected.distance);
+                for (std::size_t i = 0; i < graph.node_count(); ++i) {
+                    auto const v = NodeIndex<DefaultIx>(i);
+                    std::size_t hops = 0;
+                    for (auto u = v; parallel.reachable(v) && u != NodeIndex<DefaultIx>(0); u = parallel.parent[u.index()]) {
+                        REQUIRE(++hops < graph.node_count());
+                        REQUIRE(parallel.parent[u.index()] != NodeIndex<DefaultIx>::end());
+                    }
+                }
+            }
+        }
+    }
+}
+
+namespace {
+
+/// Runs shortest_paths() with every cost converted to `T` and checks it
+/// against dijkstra() on 64-bit integer costs, including the tree.
+template <typename T, typename G>
+void check_cost_type(G const& graph)
+{
+    using Ix = DefaultIx;
+    auto const as = [](typename G::edge_reference_t const& e) { return static_cast<T>(e.weight()); };
+    auto const wide = [](typename G::edge_reference_t const& e) { return static_cast<std::int64_t>(e.weight()); };
+    auto const expected = dijkstra(graph, NodeIndex<Ix>(0), wide);
+
+    ShortestPathWorkspace<Ix, T> ws;
+    for (int round = 0; round < 2; ++round) {
+        shortest_paths(graph, NodeIndex<Ix>(0), as, ws);
+        for (std::size_t i = 0; i < graph.node_count(); ++i) {
+            auto const v = NodeIndex<Ix>(i);
+            REQUIRE(ws.reachable(v) == expected.reachable(v));
+            if (!expected.reachable(v) || v == NodeIndex<Ix>(0)) {
+                continue;
+            }
+            REQUIRE(static_cast<std::int64_t>(ws.distance_to(v)) == expected.distance[i]);
+            auto const parent = ws.parent_of(v);
+            auto const e = ws.parent_edge_of(v);
+            REQUIRE(graph.edge_endpoints(e) == std::make_pair(parent, v));
+            REQUIRE(static_cast<std::int64_t>(ws.distance_to(parent)) + graph.edge_weight(e) == expected.distance[i]);
+        }
+    }
+
+    auto const to_half = shortest_paths(graph, NodeIndex<Ix>(0), as, NodeIndex<Ix>(graph.node_count() / 2));
+    REQUIRE(static_cast<std::int64_t>(to_half.distance[graph.node_count() / 2]) == expected.distance[graph.node_count() / 2]);
+}
+
+}
+
+static_assert(cost_traits<NoWeight>::kind == CostKind::Unit, "E = void graphs count hops");
+static_assert(cost_traits<char>::kind == CostKind::SmallInteger, "the default edge type uses Dial's buckets");
+static_assert(cost_traits<std::uint8_t>::kind == CostKind::SmallInteger, "");
+static_assert(cost_traits<int>::kind == CostKind::Integer, "");
+static_assert(cost_traits<std::uint64_t>::kind == CostKind::Integer, "");
+static_assert(cost_traits<float>::kind == CostKind::General, "");
+static_assert(cost_traits<double>::kind == CostKind::General, "");
+static_assert(std::is_same<cost_distance_t<std::uint8_t>, std::uint64_t>::value, "8-bit costs are summed without overflow");
+static_assert(std::is_same<cost_distance_t<unsigned short>, std::uint64_t>::value, "");
+static_assert(std::is_same<cost_distance_t<int>, std::int64_t>::value, "");
+static_assert(std::is_same<cost_distance_t<std::uint64_t>, std::uint64_t>::value, "");
+static_assert(std::is_same<cost_distance_t<double>, double>::value, "");
+
+SCENARIO("Shortest paths dispatch on the cost type", "[shortest-paths]")
+{
+
+    GIVEN("A random graph with small integer costs, zeros included")
+    {
+
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> node(0, 399);
+        std::uniform_int_distribution<int> cost(0, 100);
+        std::vector<std::tuple<int, int, int>> edge_list;
+        for (int i = 0; i < 2400; ++i) {
+            edge_list.emplace_back(node(rng), node(rng), cost(rng));
+        }
+        auto const graph = from_edges<DiGraph<int, int>>(edge_list, 400);
+
+        THEN("Every integer and floating-point kernel agrees with Dijkstra")
+        {
+            check_cost_type<char>(graph);
+            check_cost_type<std::uint8_t>(graph);
+            check_cost_type<short>(graph);
+            check_cost_type<int>(graph);
+            check_cost_type<unsigned>(graph);
+            check_cost_type<std::int64_t>(graph);
+            check_cost_type<double>(graph);
+            check_cost_type<std::int64_t>(freeze(graph));
+        }
+    }
+
+    GIVEN("Costs spanning forty bits")
+    {
+
+        std::mt19937_64 rng(5);
+        std::uniform_int_distribution<int> node(0, 299);
+        std::uniform_int_distribution<std::int64_t> cost(0, std::int64_t(1) << 40);
+        std::vector<std::tuple<int, int, std::int64_t>> edge_list;
+        for (int i = 0; i < 1500; ++i) {
+            edge_list.emplace_back(node(rng), node(rng), cost(rng));
+        }
+        auto const graph = from_edges<DiGraph<int, std::int64_t>>(edge_list, 300);
+
+        THEN("The radix heap matches Dijkstra")
+        {
+            auto const expected = dijkstra(graph, NodeIndex<DefaultIx>(0), [](auto const& e) { return e.weight(); });
+            auto const result = shortest_paths(graph, NodeIndex<DefaultIx>(0));
+            REQUIRE(result.distance == expected.distance);
+        }
+    }
+
+    GIVEN("An unweighted graph and the default char-weighted graph")
+    {
+
+        std::vector<std::pair<int, int>> edge_list{{0, 1}, {1, 2}, {0, 3}, {3, 2}, {2, 4}};
+        auto const hops = from_edges<DiGraph<int, void>>(edge_list);
+        std::vector<std::tuple<int, int, char>> weighted{{0, 1, 100}, {1, 2, 100}, {0, 3, 1}, {3, 2, 120}, {2, 4, 127}};
+        auto const chars = from_edges<Graph<int>>(weighted);
+
+        THEN("Unit costs count hops by breadth-first search")
+        {
+            auto const result = shortest_paths(hops, NodeIndex<DefaultIx>(0));
+            REQUIRE(result.distance == (std::vector<std::size_t>{0, 1, 2, 1, 3}));
+        }
+
+        THEN("char costs are summed past the range of char")
+        {
+            auto const result = shortest_paths(chars, NodeIndex<DefaultIx>(0));
+            REQUIRE(result.distance == (std::vector<cost_distance_t<char>>{0, 100, 121, 1, 248}));
+            auto const by_dijkstra = dijkstra(chars, NodeIndex<DefaultIx>(0), [](auto const& e) { return e.weight(); });
+            REQUIRE(by_dijkstra.distance == result.distance);
+            REQUIRE(result.path_to(NodeIndex<DefaultIx>(4)) == (std::vector<NodeIndex<DefaultIx>>{NodeIndex<DefaultIx>(0), NodeIndex<DefaultIx>(3), NodeIndex<DefaultIx>(2), NodeIndex<DefaultIx>(4)}));
+        }
+    }
+    GIVEN("A chain whose length exceeds the largest unsigned short")
+    {
+
+        Graph<int, unsigned short> graph;
+        for (int i = 0; i < 4; ++i) {
+            graph.add_node(i);
+        }
+        for (DefaultIx i = 0; i < 3; ++i) {
+            graph.add_edge(NodeIndex<DefaultIx>(i), NodeIndex<DefaultIx>(i + 1), 30000);
+        }
+        auto const weight = [](auto const& e) { return e.weight(); };
+        auto const end = NodeIndex<DefaultIx>(3);
+
+        THEN("Every search sums the costs in 64 bits")
+        {
+            REQUIRE(shortest_paths(graph, NodeIndex<DefaultIx>(0)).distance_to(end) == 90000);
+            REQUIRE(dijkstra(graph, NodeIndex<DefaultIx>(0), weight).distance_to(end) == 90000);
+            REQUIRE(bidirectional_dijkstra(graph, NodeIndex<DefaultIx>(0), end, weight).distance == 90000);
+            REQUIRE(astar(graph, NodeIndex<DefaultIx>(0), end, weight, [](NodeIndex<DefaultIx>) { return 0; }).distance == 90000);
+            REQUIRE(contract(graph, weight).query(NodeIndex<DefaultIx>(0), end).distance == 90000);
+        }
+    }
+}
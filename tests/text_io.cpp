@@ -0,0 +1,209 @@
+#include "io/text.hpp"
+#include <catch.hpp>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+template <typename G>
+bool has_edge(G const& graph, std::size_t a, std::size_t b, typename G::edge_weight_t weight)
+{
+    for (auto const& edge : graph.edges_of(NodeIndex<DefaultIx>(static_cast<DefaultIx>(a)))) {
+        if (edge.target().index() == b && edge.weight() == weight) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+SCENARIO("Text graph formats", "[text-io]")
+{
+
+    GIVEN("A whitespace edge list with comments and blank lines")
+    {
+
+        std::string const text = "# comment\n0 1 2.5\n\n1\t2 0.5\r\n% another\n4 0 1\n";
+
+        WHEN("It is read")
+        {
+
+            std::istringstream in(text);
+            auto const graph = read_edge_list<DiGraph<int, double>>(in);
+
+            THEN("Every edge and the highest node are present")
+            {
+                REQUIRE(graph.node_count() == 5);
+                REQUIRE(graph.edge_count() == 3);
+                REQUIRE(has_edge(graph, 0, 1, 2.5));
+                REQUIRE(has_edge(graph, 1, 2, 0.5));
+                REQUIRE(has_edge(graph, 4, 0, 1.0));
+            }
+        }
+    }
+
+    GIVEN("A long edge list read through a tiny buffer")
+    {
+
+        std::ostringstream out;
+        const int num_edges = 5000;
+        for (int i = 0; i < num_edges; ++i) {
+            out << i % 97 << ' ' << (i * 7) % 101 << ' ' << i << '\n';
+        }
+        std::string const text = out.str();
+
+        WHEN("It is read sequentially and in parallel")
+        {
+
+            TextReadOptions small;
+            small.buffer_size = 300;
+            std::istringstream in1(text);
+            auto const sequential = read_edge_list<DiGraph<int, int>>(in1, small);
+
+            ThreadPool pool(3);
+            TextReadOptions parallel = small;
+            parallel.pool = &pool;
+            std::istringstream in2(text);
+            auto const threaded = read_edge_list<DiGraph<int, int>>(in2, parallel);
+
+            THEN("Both keep file order")
+            {
+                REQUIRE(sequential.edge_count() == num_edges);
+                REQUIRE(threaded.edge_count() == num_edges);
+                for (int i = 0; i < num_edges; ++i) {
+                    auto const e = EdgeIndex<DefaultIx>(i);
+                    REQUIRE(sequential.edge_weight(e) == i);
+                    REQUIRE(threaded.edge_weight(e) == i);
+                    REQUIRE(threaded.edge_endpoints(e) == sequential.edge_endpoints(e));
+                }
+                REQUIRE(threaded.nodes[5].next == sequential.nodes[5].next);
+            }
+        }
+    }
+
+    GIVEN("A DIMACS shortest-path file")
+    {
+
+        std::string const text = "c sample\np sp 4 3\nc arcs follow\na 1 2 10\na 2 3 20\na 1 3 40\n";
+
+        WHEN("It is read")
+        {
+
+            std::istringstream in(text);
+            auto const graph = read_dimacs<DiGraph<int, int>>(in);
+
+            THEN("Ids are shifted to 0-based and isolated nodes are kept")
+            {
+                REQUIRE(graph.node_count() == 4);
+                REQUIRE(graph.edge_count() == 3);
+                REQUIRE(has_edge(graph, 0, 1, 10));
+                REQUIRE(has_edge(graph, 0, 2, 40));
+            }
+        }
+
+        WHEN("The problem line is missing")
+        {
+
+            std::istringstream in("a 1 2 10\n");
+
+            THEN("Reading fails")
+            {
+                REQUIRE_THROWS_AS((read_dimacs<DiGraph<int, int>>(in)), std::runtime_error);
+            }
+        }
+
+        WHEN("The problem line has a malformed node count")
+        {
+
+            std::istringstream in("p sp 4x 3\na 1 2 10\n");
+
+            THEN("Reading fails with a runtime_error")
+            {
+                REQUIRE_THROWS_AS((read_dimacs<DiGraph<int, int>>(in)), std::runtime_error);
+            }
+        }
+
+        WHEN("The problem line declares more nodes than the index type holds")
+        {
+
+            THEN("Reading fails with a runtime_error instead of creating or allocating them")
+            {
+                std::istringstream narrow("p sp 100000 1\na 1 2 10\n");
+                REQUIRE_THROWS_AS((read_dimacs<DiGraph<int, int, std::uint16_t>>(narrow)), std::runtime_error);
+                std::istringstream huge("p sp 4000000000000 1\na 1 2 10\n");
+                REQUIRE_THROWS_AS((read_dimacs<DiGraph<int, int>>(huge)), std::runtime_error);
+            }
+        }
+    }
+
+    GIVEN("A symmetric Matrix Market file")
+    {
+
+        std::string const text = "%%MatrixMarket matrix coordinate real symmetric\n% comment\n3 3 3\n2 1 1.5\n3 1 2.5\n3 3 4.0\n";
+
+        WHEN("It is read into a directed graph")
+        {
+
+            std::istringstream in(text);
+            auto const graph = read_matrix_market<DiGraph<int, float>>(in);
+
+            THEN("Off-diagonal entries are mirrored")
+            {
+                REQUIRE(graph.node_count() == 3);
+                REQUIRE(graph.edge_count() == 5);
+                REQUIRE(has_edge(graph, 1, 0, 1.5f));
+                REQUIRE(has_edge(graph, 0, 1, 1.5f));
+                REQUIRE(has_edge(graph, 2, 2, 4.0f));
+            }
+        }
+
+        WHEN("It is read into an undirected graph")
+        {
+
+            std::istringstream in(text);
+            auto const graph = read_matrix_market<UnGraph<int, float>>(in);
+
+            THEN("Each entry is one edge")
+            {
+                REQUIRE(graph.edge_count() == 3);
+                REQUIRE(has_edge(graph, 0, 2, 2.5f));
+            }
+        }
+    }
+
+    GIVEN("A malformed line")
+    {
+
+        std::istringstream in("0 1\n2 x\n");
+
+        THEN("Reading fails with the offending text")
+        {
+            REQUIRE_THROWS_AS((read_edge_list<DiGraph<int, int>>(in)), std::runtime_error);
+        }
+    }
+
+    GIVEN("Numbers followed by garbage")
+    {
+
+        THEN("A weight with trailing text is rejected")
+        {
+            std::istringstream in("0 1 2.5kg\n");
+            REQUIRE_THROWS_AS((read_edge_list<DiGraph<int, float>>(in)), std::runtime_error);
+        }
+
+        THEN("An out-of-range Matrix Market size is rejected as malformed")
+        {
+            std::istringstream in("%%MatrixMarket matrix coordinate pattern general\n99999999999999999999999 3 1\n1 2\n");
+            REQUIRE_THROWS_AS((read_matrix_market<DiGraph<int, int>>(in)), std::runtime_error);
+        }
+
+        THEN("A Matrix Market size beyond the index type is rejected")
+        {
+            std::istringstream in("%%MatrixMarket matrix coordinate pattern general\n3 70000 1\n1 2\n");
+            REQUIRE_THROWS_AS((read_matrix_market<DiGraph<int, int, std::uint16_t>>(in)), std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,265 @@
+#include "algorithms/dijkstra.hpp"
+#include "algorithms/point_to_point.hpp"
+#include "algorithms/shortest_paths.hpp"
+#include "versioned_graph.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
+#include <catch.hpp>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename G>
+std::vector<std::pair<std::size_t, std::size_t>> adjacency(G const& graph, NodeIndex<DefaultIx> node, Direction::Direction dir)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    for (auto const& edge : graph.edges_directed(node, dir)) {
+        auto const other = dir == Direction::Direction::Outgoing ? edge.target() : edge.source();
+        result.push_back(std::make_pair(edge.id().index(), other.index()));
+    }
+    return result;
+}
+
+SCENARIO("Versioned graph", "[versioned]")
+{
+
+    GIVEN("A versioned graph with one published batch")
+    {
+
+        VersionedGraph<int, double> graph;
+        auto const a = graph.add_node(0);
+        auto const b = graph.add_node(1);
+        auto const c = graph.add_node(2);
+        graph.add_edge(a, b, 1.0);
+        graph.add_edge(b, c, 2.0);
+        graph.add_edge(a, c, 5.0);
+        graph.add_edge(c, c, 0.5);
+
+        auto const reader = graph.reader();
+
+        WHEN("Nothing is published")
+        {
+
+            THEN("Readers see the empty version 0")
+            {
+                auto const snapshot = reader.pin();
+                REQUIRE(snapshot->version == 0);
+                REQUIRE(snapshot->node_count() == 0);
+                REQUIRE(graph.has_pending());
+                REQUIRE(graph.pending().edge_count() == 4);
+            }
+        }
+
+        WHEN("The batch is published")
+        {
+
+            REQUIRE(graph.publish() == 1);
+            REQUIRE_FALSE(graph.has_pending());
+            REQUIRE(graph.publish() == 1);
+
+            THEN("Readers see the same graph Graph would build")
+            {
+                DiGraph<int, double> plain;
+                for (int i = 0; i < 3; ++i) {
+                    plain.add_node(i);
+                }
+                plain.add_edge(a, b, 1.0);
+                plain.add_edge(b, c, 2.0);
+                plain.add_edge(a, c, 5.0);
+                plain.add_edge(c, c, 0.5);
+
+                auto const snapshot = reader.pin();
+                REQUIRE(snapshot->version == 1);
+                REQUIRE(snapshot->node_count() == 3);
+                REQUIRE(snapshot->edge_count() == 4);
+                REQUIRE(snapshot->node_weight(c) == 2);
+                REQUIRE(snapshot->edge_weight(EdgeIndex<DefaultIx>(2)) == 5.0);
+                REQUIRE(snapshot->edge_endpoints(EdgeIndex<DefaultIx>(1)) == std::make_pair(b, c));
+                REQUIRE(snapshot->degree(c, Direction::Direction::Ingoing) == 3);
+                for (auto const n : {a, b, c}) {
+                    for (auto const dir : {Direction::Direction::Outgoing, Direction::Direction::Ingoing}) {
+                        REQUIRE(adjacency(*snapshot, n, dir) == adjacency(plain, n, dir));
+                    }
+                }
+            }
+
+            THEN("Algorithms run on a snapshot")
+            {
+                auto const snapshot = reader.pin();
+                SearchWorkspace<DefaultIx, double> ws;
+                dijkstra(*snapshot, a, [](EdgeReference<double, DefaultIx> const& e) { return e.weight(); }, ws);
+                REQUIRE(ws.distance_to(c) == 3.0);
+                SearchWorkspace<DefaultIx> hops;
+                breadth_first_search(*snapshot, a, hops);
+                REQUIRE(hops.distance_to(c) == 1.0);
+
+                auto const weight = [](EdgeReference<double, DefaultIx> const& e) { return e.weight(); };
+                REQUIRE(shortest_paths(*snapshot, a).distance_to(c) == 3.0);
+                REQUIRE(bidirectional_dijkstra(*snapshot, a, c, weight).distance == 3.0);
+                REQUIRE(astar(*snapshot, a, c, weight, [](NodeIndex<DefaultIx>) { return 0.0; }).distance == 3.0);
+                std::size_t discovered = 0;
+                depth_first_search(*snapshot, a, [&](DfsEvent<NodeIndex<DefaultIx>> const& event) {
+                    discovered += event.kind == DfsEvent<NodeIndex<DefaultIx>>::Kind::Discover;
+                });
+                REQUIRE(discovered == 3);
+            }
+
+            AND_WHEN("A pinned reader outlives the next publish")
+            {
+
+                auto const old = reader.pin();
+                auto const d = graph.add_node(3);
+                graph.add_edge(c, d, 1.0);
+                graph.set_edge_weight(EdgeIndex<DefaultIx>(0), 9.0);
+                graph.set_node_weight(a, 10);
+                REQUIRE(graph.publish() == 2);
+
+                THEN("Its snapshot is unchanged and kept alive")
+                {
+                    REQUIRE(old->version == 1);
+                    REQUIRE(old->node_count() == 3);
+                    REQUIRE(old->edge_count() == 4);
+                    REQUIRE(old->edge_weight(EdgeIndex<DefaultIx>(0)) == 1.0);
+                    REQUIRE(old->node_weight(a) == 0);
+                    REQUIRE(adjacency(*old, c, Direction::Direction::Outgoing).size() == 1);
+                    REQUIRE(graph.reclaim() == 1);
+                }
+
+                THEN("A second reader sees the new version")
+                {
+                    auto const other = graph.reader();
+                    auto const snapshot = other.pin();
+                    REQUIRE(snapshot->version == 2);
+                    REQUIRE(snapshot->edge_weight(EdgeIndex<DefaultIx>(0)) == 9.0);
+                    REQUIRE(snapshot->node_weight(a) == 10);
+                    REQUIRE(adjacency(*snapshot, c, Direction::Direction::Outgoing).size() == 2);
+                }
+            }
+
+            AND_WHEN("No reader is pinned at the next publish")
+            {
+
+                graph.add_node(3);
+                graph.publish();
+
+                THEN("The replaced version is freed at once")
+                {
+                    REQUIRE(graph.reclaim() == 0);
+                }
+            }
+        }
+    }
+
+    GIVEN("A versioned copy of a graph spanning several chunks")
+    {
+
+        constexpr std::size_t n = 3 * ChunkedArray<int>::chunk_size;
+        DiGraph<int, int> plain;
+        for (std::size_t i = 0; i < n; ++i) {
+            plain.add_node(static_cast<int>(i));
+        }
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            plain.add_edge(NodeIndex<DefaultIx>(i), NodeIndex<DefaultIx>(i + 1), 1);
+        }
+        VersionedGraph<int, int> graph(plain);
+
+        WHEN("A batch touches only the last nodes")
+        {
+
+            auto const reader = graph.reader();
+            auto const before = reader.pin();
+            auto const* first = before->nodes.chunks.front().get();
+            graph.add_edge(NodeIndex<DefaultIx>(n - 2), NodeIndex<DefaultIx>(n - 1), 7);
+            graph.publish();
+
+            THEN("The untouched chunks are shared with the previous version")
+            {
+                auto const& latest = graph.latest();
+                REQUIRE(latest.nodes.chunks.front().get() == first);
+                REQUIRE(latest.nodes.chunks[1].get() == before->nodes.chunks[1].get());
+                REQUIRE(latest.nodes.chunks.back().get() != before->nodes.chunks.back().get());
+                REQUIRE(latest.edges.edges.chunks.front().get() == before->edges.edges.chunks.front().get());
+                REQUIRE(before->edge_count() == n - 1);
+                REQUIRE(latest.edge_count() == n);
+                REQUIRE(latest.degree(NodeIndex<DefaultIx>(n - 2)) == 2);
+            }
+        }
+    }
+
+    GIVEN("A versioned graph with two reader slots")
+    {
+
+        VersionedGraph<int> graph(2);
+        auto const first = graph.reader();
+
+        THEN("A third reader is refused until a slot is released")
+        {
+            {
+                auto const second = graph.reader();
+                REQUIRE_THROWS_AS(graph.reader(), std::length_error);
+            }
+            REQUIRE_NOTHROW(graph.reader());
+        }
+    }
+
+    GIVEN("Readers pinning while a writer publishes")
+    {
+
+        VersionedGraph<int, int> graph;
+        for (int i = 0; i < 64; ++i) {
+            graph.add_node(i);
+        }
+        graph.publish();
+
+        std::atomic<bool> done{false};
+        std::atomic<bool> consistent{true};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                auto const reader = graph.reader();
+                std::uint64_t last = 0;
+                while (!done.load()) {
+                    auto const snapshot = reader.pin();
+                    // Batch `v` adds 16 edges, so every published version has
+                    // exactly 16 * (v - 1) of them and never goes back.
+                    std::size_t out = 0;
+                    for (std::size_t i = 0; i < snapshot->node_count(); ++i) {
+                        out += snapshot->degree(NodeIndex<DefaultIx>(i));
+                    }
+                    auto ok = snapshot->version >= last && snapshot->edge_count() == 16 * (snapshot->version - 1) && out == snapshot->edge_count();
+                    if (!ok) {
+                        consistent.store(false);
+                    }
+                    last = snapshot->version;
+                }
+            });
+        }
+
+        WHEN("The writer publishes many batches")
+        {
+
+            std::mt19937 rng(3);
+            std::uniform_int_distribution<int> node(0, 63);
+            for (int batch = 0; batch < 300; ++batch) {
+                for (int i = 0; i < 16; ++i) {
+                    graph.add_edge(NodeIndex<DefaultIx>(node(rng)), NodeIndex<DefaultIx>(node(rng)), batch);
+                }
+                graph.publish();
+            }
+            done.store(true);
+            for (auto& thread : readers) {
+                thread.join();
+            }
+
+            THEN("Every snapshot a reader saw was a whole version, and all replaced versions are freed")
+            {
+                REQUIRE(consistent.load());
+                REQUIRE(graph.latest().version == 301);
+                REQUIRE(graph.reclaim() == 0);
+            }
+        }
+    }
+}
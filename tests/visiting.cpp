@@ -1,6 +1,35 @@
 #include "graph.hpp"
+#include "csr.hpp"
+#include "visit/bfsvisit.hpp"
+#include "visit/dfsvisit.hpp"
 #include <catch.hpp>
 #include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Event = DfsEvent<NodeIndex<DefaultIx>>;
+
+std::string describe(Event const& event)
+{
+    switch (event.kind) {
+    case Event::Kind::Discover:
+        return "D" + std::to_string(event.discover.source.index()) + "@" + std::to_string(event.discover.time);
+    case Event::Kind::TreeEdge:
+        return "T" + std::to_string(event.tree_edge.source.index()) + std::to_string(event.tree_edge.target.index());
+    case Event::Kind::BackEdge:
+        return "B" + std::to_string(event.back_edge.source.index()) + std::to_string(event.back_edge.target.index());
+    case Event::Kind::CrossForwardEdge:
+        return "C" + std::to_string(event.cross_forward_edge.source.index()) + std::to_string(event.cross_forward_edge.target.index());
+    case Event::Kind::Finish:
+        return "F" + std::to_string(event.finish.source.index()) + "@" + std::to_string(event.finish.time);
+    }
+    return "";
+}
+
+}
 
 SCENARIO("Visiting", "[visiting]")
 {
@@ -71,4 +100,178 @@ SCENARIO("Visiting", "[visiting]")
         }
 
     }
+
+    GIVEN("A small directed graph with a cycle and a cross edge")
+    {
+
+        DiGraph<int, int> graph;
+        std::vector<NodeIndex<DefaultIx>> n;
+
+        for (int i = 0; i < 4; ++i) {
+            n.push_back(graph.add_node(i));
+        }
+        // Chains are walked newest first, so 0 visits 1 before 2.
+        graph.add_edge(n[0], n[2], 0);
+        graph.add_edge(n[0], n[1], 0);
+        graph.add_edge(n[1], n[0], 0);
+        graph.add_edge(n[2], n[1], 0);
+
+        WHEN("It is searched depth first from node 0")
+        {
+
+            std::vector<std::string> events;
+            depth_first_search(graph, n[0], [&](Event const& event) { events.push_back(describe(event)); });
+
+            THEN("Every event kind is reported with discover and finish times")
+            {
+                std::vector<std::string> expected = {"D0@0", "T01", "D1@1", "B10", "F1@2", "T02", "D2@3", "C21", "F2@4", "F0@5"};
+                REQUIRE(events == expected);
+            }
+        }
+
+        WHEN("The visitor prunes node 1 and breaks on node 2")
+        {
+
+            std::vector<std::string> events;
+            auto const result = depth_first_search(graph, n[0], [&](Event const& event) -> ControlFlow<int> {
+                events.push_back(describe(event));
+                if (event.kind == Event::Kind::Discover && event.discover.source == n[1]) {
+                    return ControlFlow<int>::Prune();
+                }
+                if (event.kind == Event::Kind::Discover && event.discover.source == n[2]) {
+                    return ControlFlow<int>::Break(42);
+                }
+                return ControlFlow<int>::Continue();
+            });
+
+            THEN("The pruned node is finished at once and the break data is returned")
+            {
+                std::vector<std::string> expected = {"D0@0", "T01", "D1@1", "F1@2", "T02", "D2@3"};
+                REQUIRE(events == expected);
+                REQUIRE(result.should_break());
+                REQUIRE(result.data == 42);
+            }
+        }
+
+        WHEN("The CSR snapshot is searched from several starts")
+        {
+
+            auto const csr = freeze(graph);
+            std::vector<std::size_t> finished;
+            DfsWorkspace<CsrGraph<int, int>> ws;
+            depth_first_search(csr, {n[3], n[2]}, [&](Event const& event) {
+                if (event.kind == Event::Kind::Finish) {
+                    finished.push_back(event.finish.source.index());
+                }
+            }, ws);
+
+            THEN("Every reachable node finishes exactly once")
+            {
+                std::vector<std::size_t> expected = {3, 0, 1, 2};
+                REQUIRE(finished == expected);
+            }
+        }
+    }
+
+    GIVEN("A path much deeper than the call stack")
+    {
+
+        DiGraph<int, int> graph;
+        const int length = 200000;
+
+        graph.add_node(0);
+        for (int i = 1; i < length; ++i) {
+            graph.add_node(i);
+            graph.add_edge(NodeIndex<DefaultIx>(i - 1), NodeIndex<DefaultIx>(i), 0);
+        }
+
+        WHEN("It is searched depth first")
+        {
+
+            std::size_t max_time = 0;
+            depth_first_search(graph, NodeIndex<DefaultIx>(0), [&](Event const& event) {
+                if (event.kind == Event::Kind::Finish) {
+                    max_time = std::max(max_time, event.finish.time);
+                }
+            });
+
+            THEN("Every node is discovered and finished")
+            {
+                REQUIRE(max_time == 2 * length - 1);
+            }
+        }
+    }
+
+    GIVEN("A random directed graph with an unreachable part")
+    {
+
+        DiGraph<int, int> graph;
+        const int num_vertices = 2000;
+        std::mt19937 rng(3);
+        std::uniform_int_distribution<DefaultIx> pick(0, num_vertices / 2 - 1);
+
+        for (int i = 0; i < num_vertices; ++i) {
+            graph.add_node(i);
+        }
+        for (int i = 0; i < 4 * num_vertices; ++i) {
+            graph.add_edge(pick(rng), pick(rng), 0);
+        }
+
+        SearchWorkspace<DefaultIx, DefaultIx> ws;
+        breadth_first_search(graph, NodeIndex<DefaultIx>(0), ws);
+
+        WHEN("The direction-optimizing search runs in each mode and thread count")
+        {
+
+            BfsOptions top_down;
+            top_down.alpha = 1;
+            BfsOptions bottom_up;
+            bottom_up.alpha = num_vertices * 100;
+            bottom_up.beta = num_vertices * 100;
+            bottom_up.grain = 64;
+
+            THEN("Each mode is actually taken")
+            {
+                ThreadPool pool(1);
+                REQUIRE(breadth_first_search(graph, NodeIndex<DefaultIx>(0), pool, top_down).bottom_up_steps == 0);
+                REQUIRE(breadth_first_search(graph, NodeIndex<DefaultIx>(0), pool, bottom_up).top_down_steps == 0);
+            }
+
+            THEN("Depths match the sequential search and parents are one hop up")
+            {
+                for (std::size_t threads : {1, 3}) {
+                    ThreadPool pool(threads);
+                    for (auto const& options : {BfsOptions(), top_down, bottom_up}) {
+                        auto const result = breadth_first_search(graph, NodeIndex<DefaultIx>(0), pool, options);
+                        for (int i = 0; i < num_vertices; ++i) {
+                            auto const v = NodeIndex<DefaultIx>(i);
+                            REQUIRE(result.reachable(v) == ws.reachable(v));
+                            if (result.reachable(v)) {
+                                REQUIRE(result.depth[i] == ws.distance_to(v));
+                            }
+                            if (result.reachable(v) && i != 0) {
+                                REQUIRE(result.depth[result.parent[i].index()] + 1 == result.depth[i]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        WHEN("The CSR snapshot is searched in parallel")
+        {
+
+            ThreadPool pool(2);
+            auto const csr = freeze(graph);
+            auto const result = breadth_first_search(csr, NodeIndex<DefaultIx>(0), pool);
+
+            THEN("It reaches the same nodes at the same depths")
+            {
+                for (int i = 0; i < num_vertices; ++i) {
+                    REQUIRE(result.reachable(NodeIndex<DefaultIx>(i)) == ws.reachable(NodeIndex<DefaultIx>(i)));
+                }
+                REQUIRE(result.depth[num_vertices / 4] == ws.distance_to(NodeIndex<DefaultIx>(num_vertices / 4)));
+            }
+        }
+    }
 }